@@ -28,22 +28,61 @@ SOFTWARE.
 
 #include <stdint.h>
 #include "audio_common.h"
+#include <stdbool.h>
 
 typedef enum {
   I2S_AUDIO_STOPPED = 0,
   I2S_AUDIO_STREAMING = 1,
+  I2S_AUDIO_STOPPING = 2, // fading out, stopped when it reaches silence
 }I2sAudioState;
 
+typedef struct {
+	uint32_t filled; // refilled periods
+	uint32_t late;   // refill started more than half a period after the DMA callback
+} I2sPeriodStats;
+
+extern I2sPeriodStats i2s_period_stats;
+
+typedef struct {
+	uint32_t short_reads;       // refills which got less samples from USB than a period
+	uint32_t concealed_samples; // samples replaced by the fade out because of short reads
+	uint32_t overruns;          // USB packets received when the FIFO had no room for another one
+} AudioStreamStats;
+
+extern AudioStreamStats audio_stream_stats;
+
 int CS43L22_init(void *i2c, void *i2s);
 
 void audio_play();
 void audio_stop();
+// like audio_stop(), for a format switch: the FIFO may already hold the new format, so the fade out
+// (also one which is already running) repeats the last played frame instead of reading it
+void audio_stop_concealed(void);
 I2sAudioState get_audio_state();
 
+// reconfigures the PLLI2S and the I2S prescaler from i2s_rate_table.h, only when stopped
+// (the codec detects the new MCLK/LRCK ratio itself), false when the rate is not supported or it is playing
+bool audio_set_sample_rate(uint32_t rate);
+uint32_t audio_get_sample_rate(void);
+bool audio_is_sample_rate_supported(uint32_t rate);
+
+// USB subslot size (2, 3 or 4 bytes) of the alternate setting the host selected, selects the unpack kernel
+// used by the refill, only when stopped
+bool audio_set_sample_bytes(uint8_t bytes);
+uint8_t audio_get_sample_bytes(void);
+
+// stereo frames played by the I2S DMA since the last call, 'elapsed_ms' is the time since the last call
+// (in USB frames), so the whole ring wraps in a longer gap are counted too
+uint16_t audio_get_played_frames(uint16_t elapsed_ms);
+
+// stereo frames of the DMA period which is playing now, which were already played
+// (the refill takes the whole period from the FIFO only after it was played)
+uint16_t audio_get_period_pos_frames(void);
+
 int CS43L22_set_master_volume_db(int16_t vol_LR);
 
 int CS43L22_set_hp_volume_db(int16_t vol_L, int16_t vol_R);
-int CS43L22_set_hp_mute(int8_t mute);
+int CS43L22_set_hp_mute(int8_t mute_L, int8_t mute_R);
 
 // value in the tone gain is a specially offsetted value unique to CS43L22 tone control
 // both needs to be set in the same register
@@ -54,5 +93,7 @@ int CS43L22_set_bass_treb_freq(uint8_t bass_id, uint8_t treb_id);
 
 int CS43L22_set_hp_analog_gain(uint8_t gain_id);
 
-int CS43L22_read_clip_reg();
+// 'result' is 1 when any of the codec's overflow flags is set (it also drives the red LED)
+// the I2C read gives up after 'timeout_ms' (per transfer), it is polled while streaming
+int CS43L22_read_clip_reg(uint8_t *result, uint32_t timeout_ms);
 
@@ -0,0 +1,68 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#pragma once
+
+#include <stdint.h>
+
+// Lightweight asynchronous sample rate converter for hosts with broken feedback.
+// It sits between the USB FIFO and the I2S buffer and consumes slightly more or less than
+// the nominal number of frames, so the host/device clock drift is absorbed without
+// dropping or repeating samples. 4 point cubic (Catmull-Rom) interpolation on 24bit values,
+// the ratio comes from a PI controller on the FIFO level.
+// Portable C, there is no HW access in it (see tools/asrc_bench.c for the host benchmark).
+
+// frames before the interpolation point which have to be kept in the input
+#define AUDIO_ASRC_HIST_FRAMES   1
+
+typedef struct {
+	uint32_t phase;      // fractional position between in[1] and in[2] as 0.32
+	int32_t ratio_adj;   // consumed frames per output frame - 1, as 0.32 (1ppm is ~4295)
+
+	// ratio controller
+	uint16_t target_frames;
+	uint32_t fifo_sum;
+	uint8_t block_cnt;
+	int32_t integ;
+	int32_t fifo_err;    // last averaged FIFO error in frames
+} AudioAsrc;
+
+void audio_asrc_init(AudioAsrc *st, uint16_t fifo_target_frames);
+
+// call once per refill with the number of buffered input frames (USB FIFO + not yet consumed)
+void audio_asrc_update(AudioAsrc *st, uint16_t fifo_frames);
+
+// input frames (including the history) needed to produce 'out_frames'
+uint16_t audio_asrc_needed(const AudioAsrc *st, uint16_t out_frames);
+
+// 'in' and 'out' are interleaved stereo Q31 frames, 'in' starts with the AUDIO_ASRC_HIST_FRAMES history.
+// Produces up to 'out_frames' and returns how many were produced.
+// '*consumed' frames can be dropped from the start of 'in', the rest is the input of the next call.
+uint16_t audio_asrc_process(AudioAsrc *st, const int32_t *in, uint16_t in_frames,
+		int32_t *out, uint16_t out_frames, uint16_t *consumed);
+
+// prints the DWT cycles per sample
+void audio_asrc_benchmark(void);
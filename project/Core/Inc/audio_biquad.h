@@ -0,0 +1,73 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#pragma once
+
+#include <stdint.h>
+
+// Fixed point stereo biquad kernels (direct form I, 32x32 -> 64bit accumulator).
+// The samples are interleaved L/R Q31 (left aligned 24bit), both channels are filtered together.
+// The coefficients are scaled down by 2^shift, so the ones above 1.0 (shelves, low corner frequencies)
+// still fit, the accumulator is shifted back by (31 - shift). The output saturates to Q31.
+
+// normalized (a0 = 1) floating point coefficients, as they are designed
+typedef struct {
+	float b0, b1, b2;
+	float a1, a2;
+} AudioBiquad;
+
+typedef struct {
+	int32_t b0, b1, b2;
+	int32_t a1, a2;  // negated, so everything is a multiply-accumulate
+	uint8_t shift;
+} AudioBiquadQ31Coef;
+
+// one channel
+typedef struct {
+	int32_t x1, x2;
+	int32_t y1, y2;
+} AudioBiquadQ31State;
+
+typedef struct {
+	AudioBiquadQ31Coef coef;
+	AudioBiquadQ31State st[2]; // L, R
+} AudioBiquadQ31;
+
+void audio_biquad_to_q31(const AudioBiquad *in, AudioBiquadQ31Coef *out);
+
+// sample by sample reference, all stages on one sample before the next one
+void audio_biquad_cascade_ref(int32_t *buf, uint16_t n_frames, AudioBiquadQ31 *stages, uint8_t n_stages);
+
+// block kernel, one stage over the whole block with the coefficients and the state in registers.
+// The L and R chains are independent and interleaved, so the dual MAC pipeline is kept busy.
+// Bit exact with the reference. tools/eq_bench.c checks this only for the plain C fallback of the host
+// build, the SMLAL inline asm of the M4 build is compared on the target in audio_biquad_benchmark().
+void audio_biquad_stereo(int32_t *buf, uint16_t n_frames, AudioBiquadQ31 *stage);
+void audio_biquad_cascade(int32_t *buf, uint16_t n_frames, AudioBiquadQ31 *stages, uint8_t n_stages);
+
+// prints the DWT cycle count of the reference and the block kernel for 5 stages,
+// and whether the SMLAL kernel is bit exact with the reference
+void audio_biquad_benchmark(void);
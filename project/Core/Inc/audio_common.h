@@ -33,3 +33,100 @@
 #define USB_MAX_VOLUME_PCT       200
 #define USB_MIN_VOLUME_PCT         0
 #define USB_VOLUME_STEP			   1
+
+// Runs the DSP/kernel benchmarks once after init and prints the DWT cycle counts (SWV ITM console)
+#ifndef CFG_AUDIO_BENCHMARK
+#define CFG_AUDIO_BENCHMARK       0
+#endif
+
+// The I2S DMA ring is split into AUDIO_PERIOD_CNT periods of AUDIO_PERIOD_US each.
+// The refill still runs only from the HAL half/complete DMA callbacks, each refills all the periods
+// the DMA has finished since the last one, so the period count sets the buffer granularity, not how
+// often the refill runs. More periods of the same ring give no more jitter safety: a late callback
+// is tolerated up to ~half the ring for any period count (see tools/period_sim.c), only the ring
+// length trades latency against it.
+//   e.g. 2 x 1000us is the classic double buffer (2ms), ~1ms late callback
+//        4 x 1000us is 4ms, ~2ms late callback
+//        3 x 2000us is 6ms, ~3ms late callback
+#ifndef AUDIO_PERIOD_CNT
+#define AUDIO_PERIOD_CNT          2
+#endif
+
+#ifndef AUDIO_PERIOD_US
+#define AUDIO_PERIOD_US           1000
+#endif
+
+// Asynchronous feedback source:
+//   1 - I2S DMA position measured on every SOF + PI controller on the FIFO level (audio_feedback.c)
+//   0 - tinyUSB AUDIO_FEEDBACK_METHOD_FIFO_COUNT
+#ifndef CFG_AUDIO_FEEDBACK_DMA
+#define CFG_AUDIO_FEEDBACK_DMA    1
+#endif
+
+// For hosts which ignore the feedback: the refill goes through a cubic ASRC (audio_asrc.c),
+// which consumes slightly more or less than the nominal rate to keep the FIFO centred.
+// (The PLLI2S can't follow the host instead: next to 48kHz its steps are ~200ppm, see
+// tools/i2s-clock-calc.py, and every switch stops the I2S.)
+// The feedback is then fixed to the nominal rate.
+#ifndef CFG_AUDIO_ASRC
+#define CFG_AUDIO_ASRC            0
+#endif
+
+// Bands of the software parametric EQ in the refill (audio_eq.c), all of them are off after init,
+// the UI presets use the first 3. The load grows linearly with the enabled bands.
+// M4 estimate for the Q31/SMLAL kernel (audio_biquad_stereo()), counted from the Cortex-M4 instruction
+// timings, per band and stereo frame: 2 loads + 2 stores ~5, SMULL/SMLAL 10, the 64bit shift and
+// saturation back to Q31 ~16, the state moves (some spilled) and the loop ~10, so ~41 cycles
+// (~21 per sample). At 48kHz that is ~2.0k cycles/ms per band, of the 96k cycles/ms at 96MHz:
+//    5 bands: ~9.8k cycles/ms (10%)
+//    8 bands: ~15.7k cycles/ms (16%)
+//   10 bands: ~19.7k cycles/ms (20%)
+// The crossfade below runs the old and the new bands, twice the load while it runs. audio_eq_benchmark()
+// (CFG_AUDIO_BENCHMARK) prints the measured DWT cycles for 5/8/10 bands on the target.
+// On a PC tools/eq_bench.c (gcc -O2, TSC around audio_eq_process() of 48 frame periods, 10 bands)
+// measured 66..90 TSC cycles per sample, i.e. 7..9 per band; those are not M4 cycles.
+#ifndef CFG_AUDIO_EQ_BANDS
+#define CFG_AUDIO_EQ_BANDS        5
+#endif
+
+// Large EQ changes run the old and the new filters in parallel and crossfade between them over this many
+// pipeline blocks (1ms each), with the double CPU load for that time. 0 - the coefficients are just swapped
+#ifndef CFG_AUDIO_EQ_XFADE_BLOCKS
+#define CFG_AUDIO_EQ_XFADE_BLOCKS 16
+#endif
+
+// Volume and balance in the refill (audio_volume.c) with smoothing, the codec HP volume
+// is written only in coarse steps. 0 - every volume change is written to the codec directly.
+#ifndef CFG_AUDIO_DIGITAL_VOLUME
+#define CFG_AUDIO_DIGITAL_VOLUME  1
+#endif
+
+// Loudness compensation stage (audio_loudness.c, table from tools/loudness-table.py),
+// switched on/off from the UI. Its makeup gain needs the headroom of the digital volume.
+#ifndef CFG_AUDIO_LOUDNESS
+#define CFG_AUDIO_LOUDNESS        1
+#endif
+
+// Bass/treble in the refill (audio_tone.c, table from tools/tone-table.py) instead of the codec's tone control
+#ifndef CFG_AUDIO_SOFT_TONE
+#define CFG_AUDIO_SOFT_TONE       0
+#endif
+
+// Look-ahead limiter after the EQ and the crossfeed (audio_limiter.c), only the tone and the dither
+// run after it. The positive tone gain lowers the limiter ceiling, 0 - it lowers the master volume instead
+// (the whole signal).
+#ifndef CFG_AUDIO_LIMITER
+#define CFG_AUDIO_LIMITER         1
+#endif
+
+// Requantization of the DSP output to 24bit, the last stage (audio_dither.c):
+//   0 - no stage, the pack truncates
+//   1 - TPDF dither
+//   2 - TPDF dither with 1st order noise shaping
+#ifndef CFG_AUDIO_DITHER
+#define CFG_AUDIO_DITHER          1
+#endif
+
+#if CFG_AUDIO_LOUDNESS && !CFG_AUDIO_DIGITAL_VOLUME
+#error "CFG_AUDIO_LOUDNESS applies its makeup gain in the headroom of the digital volume, enable CFG_AUDIO_DIGITAL_VOLUME"
+#endif
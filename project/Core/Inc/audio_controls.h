@@ -34,6 +34,9 @@ typedef enum {
 	AUDIO_CONTROL_TREB_FREQ,
 	AUDIO_CONTROL_BALANCE,
 	AUDIO_CONTROL_ANALOG_GAIN,
+	AUDIO_CONTROL_CROSSFEED,
+	AUDIO_CONTROL_LOUDNESS,
+	AUDIO_CONTROL_EQ,
 
 	// for now these are controlled only from USB
 	AUDIO_CONTROL_VOLUME,
@@ -45,12 +48,38 @@ typedef enum {
 // sends all tone related settings to the codec
 void audio_init();
 
-// call to get/set an absolute value to the volume
-void audio_set_volume_usb_pct(int16_t volume_pct);
-int16_t audio_get_volume_usb_pct(void);
-// call to get/set an absolute value to the mute
-void audio_set_mute(int8_t mute);
-int8_t audio_get_mute(void);
+// after the pipeline stages got the new rate, sends the settings which moved between the codec and the pipeline
+void audio_controls_sample_rate_changed(void);
+
+// the USB feature unit channels: 0 is the master, 1 and 2 are L and R (on top of the master and the balance)
+#define AUDIO_USB_CHANNEL_CNT   3
+
+// the codec gets the host's volume/mute at most this often, the values in between are dropped
+#define AUDIO_CONTROL_SYNC_MS   20
+
+// call from the main loop, sends the volume/mute changed by the host to the codec
+void audio_controls_task(void);
+
+typedef struct {
+	uint32_t requests;      // volume/mute changes from the host
+	uint32_t codec_syncs;   // times they were sent to the codec
+} AudioControlStats;
+
+extern AudioControlStats audio_control_stats;
+
+// The setters below only store the value (they are called from the USB control requests),
+// the codec is updated later by audio_controls_task(). The getters return the stored value right away.
+
+// call to get/set an absolute value to the volume of a channel
+void audio_set_volume_usb_pct(uint8_t channel, int16_t volume_pct);
+int16_t audio_get_volume_usb_pct(uint8_t channel);
+// UAC2: get/set the volume in 1/256dB, the range is the one the codec is used in (not the codec's full range)
+void audio_set_volume_db_256(uint8_t channel, int16_t volume);
+int16_t audio_get_volume_db_256(uint8_t channel);
+void audio_get_volume_range_db_256(int16_t *min, int16_t *max, int16_t *res);
+// call to get/set an absolute value to the mute of a channel
+void audio_set_mute(uint8_t channel, int8_t mute);
+int8_t audio_get_mute(uint8_t channel);
 
 
 // call to increase the given audio control by 1 step
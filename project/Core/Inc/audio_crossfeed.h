@@ -0,0 +1,89 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_biquad.h"
+#include "audio_pipeline.h"
+
+// Headphone crossfeed (Bauer/Linkwitz style): each output gets the opposite channel delayed
+// (interaural time difference, fractional delay with linear interpolation) and low passed
+// (head shadow, one Q31 biquad per channel with the feed level in its coefficients).
+// The direct path gets the same low pass subtracted (x - lp(x)), so a mono signal keeps its level
+// at low frequencies (no clipping) and the highs are not attenuated. Only around the cutoff the cross
+// path's delay leaves a ripple in the mono response (-2.2..+0.6dB for bs2b, see tools/crossfeed_bench.c),
+// the output saturates.
+// Portable C, the preset is set from the main loop and the refill picks it up at the next block.
+
+typedef enum {
+	AUDIO_CROSSFEED_OFF = 0,
+	AUDIO_CROSSFEED_MEIER,    // 650Hz,  9.5dB, 250us - subtle
+	AUDIO_CROSSFEED_CHU_MOY,  // 700Hz,  6.0dB, 280us
+	AUDIO_CROSSFEED_BS2B,     // 700Hz,  4.5dB, 300us - strongest
+
+	AUDIO_CROSSFEED_PRESET_CNT
+} AudioCrossfeedPreset;
+
+typedef struct {
+	const char *name;   // max 5 chars, shown on the UI
+	float cutoff;       // Hz, of the low pass in the cross path
+	float feed_db;      // cross path level below the direct path (at DC)
+	float delay_us;     // of the cross path
+} AudioCrossfeedParams;
+
+extern const AudioCrossfeedParams audio_crossfeed_presets[AUDIO_CROSSFEED_PRESET_CNT];
+
+// the opposite channel's delay is max this long (300us at 88.2kHz is 26.5)
+#define AUDIO_CROSSFEED_MAX_DELAY    32
+
+typedef struct {
+	AudioBiquadQ31Coef lp;      // low pass with the feed gain, subtracted from the direct path, fed to the cross path
+	uint8_t delay;              // whole samples
+	uint16_t frac;              // Q15 fraction of the delay
+} AudioCrossfeedCoef;
+
+// pure design, also used by the host test
+void audio_crossfeed_calc(const AudioCrossfeedParams *p, float sample_rate, AudioCrossfeedCoef *c);
+
+void audio_crossfeed_init(uint32_t sample_rate);
+
+// AUDIO_CROSSFEED_OFF bypasses the stage (crossfaded by the pipeline)
+void audio_crossfeed_set_preset(AudioCrossfeedPreset preset);
+
+// the current preset for the new rate, see AudioStage.set_sample_rate
+void audio_crossfeed_set_sample_rate(uint32_t sample_rate);
+
+// 'buf' is 'n_frames' (max AUDIO_PIPELINE_BLOCK_FRAMES) interleaved stereo Q31 samples, processed in place
+void audio_crossfeed_process(int32_t *buf, uint16_t n_frames);
+
+void audio_crossfeed_reset(void);
+
+extern AudioStage audio_crossfeed_stage;
+
+// prints the DWT cycles per sample of one block
+void audio_crossfeed_benchmark(void);
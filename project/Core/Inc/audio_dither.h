@@ -0,0 +1,56 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_pipeline.h"
+
+// Requantization of the Q31 pipeline output to the 24bit the codec gets, instead of the truncation
+// in the pack: TPDF dither (+-1 LSB) and rounding, optionally with a 1st order error feedback
+// noise shaper which moves the noise (dither included) from the low to the high frequencies.
+// The PRNG is a 32bit xorshift, one call per stereo frame gives the 2 TPDF values (4 x 8bit uniform).
+// A block which is already 24bit exact (nothing changed it, or digital silence) is not touched.
+// Portable C, see tools/dither_test.c for the noise spectrum.
+
+typedef enum {
+	AUDIO_DITHER_OFF = 0,     // rounding only
+	AUDIO_DITHER_TPDF,
+	AUDIO_DITHER_SHAPED,      // TPDF + 1st order noise shaping
+} AudioDitherMode;
+
+void audio_dither_init(AudioDitherMode mode);
+
+void audio_dither_set_mode(AudioDitherMode mode);
+
+// 'buf' is 'n_frames' interleaved stereo Q31 samples, rounded to 24bit in place
+void audio_dither_process(int32_t *buf, uint16_t n_frames);
+
+extern AudioStage audio_dither_stage;
+
+// prints the DWT cycles per sample of one block for each mode
+void audio_dither_benchmark(void);
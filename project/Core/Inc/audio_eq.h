@@ -0,0 +1,104 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_biquad.h"
+#include "audio_pipeline.h"
+
+// Parametric EQ on the MCU, CFG_AUDIO_EQ_BANDS cascaded biquads on both channels.
+// The filters are designed in float and run in fixed point (audio_biquad.c, SMLAL with 64bit accumulators).
+// The coefficients are computed in audio_eq_set_band() / audio_eq_set_preset() (main loop) and handed over in a double buffered
+// parameter block (audio_params.h), the refill picks them up at the next block, so there is no trigonometry
+// in the ISR. Large changes (band on/off, type, >=3dB, >1/3 octave) are crossfaded, see CFG_AUDIO_EQ_XFADE_BLOCKS.
+// Portable C, there is no HW access in it (see tools/eq_bench.c for the host benchmark).
+
+typedef enum {
+	AUDIO_EQ_PEAK = 0,
+	AUDIO_EQ_LOW_SHELF,
+	AUDIO_EQ_HIGH_SHELF,
+	AUDIO_EQ_HIGH_PASS,
+	AUDIO_EQ_LOW_PASS,
+} AudioEqType;
+
+typedef struct {
+	bool enabled;
+	AudioEqType type;
+	float freq;     // Hz, center or corner frequency
+	float gain_db;  // peak and shelf only
+	float q;        // bandwidth, for the shelves it is the slope (0.707 is the steepest without a bump)
+} AudioEqBand;
+
+// presets for the UI, each one sets the first AUDIO_EQ_PRESET_BANDS bands.
+// They only cut (like the loudness), a boost would clip in the biquads before the limiter could see it.
+typedef enum {
+	AUDIO_EQ_FLAT = 0,      // all bands off
+	AUDIO_EQ_BASS,          // everything above the bass down
+	AUDIO_EQ_VOCAL,         // the bass and the highs down
+	AUDIO_EQ_SMILE,         // the mids down
+
+	AUDIO_EQ_PRESET_CNT
+} AudioEqPreset;
+
+#define AUDIO_EQ_PRESET_BANDS   3
+
+typedef struct {
+	const char *name;       // max 5 chars, shown on the UI
+	AudioEqBand bands[AUDIO_EQ_PRESET_BANDS];
+} AudioEqPresetParams;
+
+extern const AudioEqPresetParams audio_eq_presets[AUDIO_EQ_PRESET_CNT];
+
+// RBJ audio EQ cookbook
+void audio_eq_calc_biquad(const AudioEqBand *band, float sample_rate, AudioBiquad *coef);
+
+void audio_eq_init(uint32_t sample_rate);
+
+// computes the band's coefficients, they are used from the next block on
+void audio_eq_set_band(uint8_t band, const AudioEqBand *cfg);
+
+// sets the bands of the preset and switches the others off, published as one block
+void audio_eq_set_preset(AudioEqPreset preset);
+
+// redesigns the bands with their last settings, see AudioStage.set_sample_rate
+void audio_eq_set_sample_rate(uint32_t sample_rate);
+
+// true when at least one band is enabled, otherwise the refill skips the EQ completely
+bool audio_eq_active(void);
+
+// 'buf' is 'n_frames' interleaved stereo Q31 samples, processed in place
+void audio_eq_process(int32_t *buf, uint16_t n_frames);
+
+// clears the filter states, called by the pipeline from the refill
+void audio_eq_reset(void);
+
+// the EQ in the refill pipeline, enabled after init (the bands decide if it does anything)
+extern AudioStage audio_eq_stage;
+
+// prints the DWT cycles per sample for 5, 8 and 10 bands
+void audio_eq_benchmark(void);
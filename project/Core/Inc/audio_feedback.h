@@ -0,0 +1,57 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Asynchronous feedback engine driven by the real I2S consumption.
+// On every USB SOF (1ms on full speed) it gets how many frames the I2S DMA played since the last update,
+// how many SOFs that was (more than 1 when a SOF interrupt was late), and the current USB FIFO level.
+// The played frames measure the I2S rate in the host's time base, which is the ideal feedback value.
+// On top of it a PI controller keeps the FIFO at the target level.
+// Portable C, there is no HW access in it.
+
+void audio_feedback_init(uint32_t sample_rate, uint16_t fifo_target_frames);
+
+// call on every SOF, 'sof_frames' is the USB frame number difference to the last call
+// 'regulate' is false when the FIFO is not consumed (playback stopped)
+// returns the feedback value: frames per SOF as 16.16, like the USB feedback EP sends it
+uint32_t audio_feedback_update(uint16_t played_frames, uint16_t sof_frames, uint16_t fifo_frames, bool regulate);
+
+// the rates are frames per SOF as 16.16, like the feedback value
+typedef struct {
+	uint32_t nominal;    // 16.16
+	uint32_t rate;       // measured I2S rate, 16.16
+	int32_t integ;       // integrator of the PI, 16.16
+	int32_t fifo_err;    // last averaged FIFO error in frames
+	uint32_t value;      // last feedback value, 16.16
+	uint32_t saturated;  // how many times the output hit the limit
+} AudioFeedbackState;
+
+extern AudioFeedbackState audio_feedback_state;
@@ -0,0 +1,46 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "tusb.h"
+#include "audio_unpack.h"
+
+// Access to the USB EP OUT FIFO (tu_fifo) itself, without the rest of the tinyUSB device stack,
+// so it can be checked on a PC against the real tusb_fifo.c (see tools/fifo_test.c and tools/salvage_test.c).
+
+// Unpacks up to 'n_samples' samples (of 'sample_bytes') straight out of the FIFO into the I2S buffer 'dst' by 'unpack'.
+// The FIFO is a ring, so its content comes in (max) 2 linear segments and a single sample
+// can be split between the end of the 1st and the start of the 2nd segment.
+// returns the number of samples actually read, only whole stereo frames are read
+uint16_t audio_fifo_read_to_i2s(tu_fifo_t *ff, uint8_t *dst, uint16_t n_samples,
+		uint8_t sample_bytes, AudioUnpackFunc unpack);
+
+// Realigns the packet of 'n_received' bytes which was just written to the FIFO and is not a multiple
+// of the stereo frame. 24bit packets are salvaged by audio_salvage_packet(), otherwise only
+// the incomplete frame at the end is dropped. Afterwards the FIFO holds whole frames again.
+void audio_fifo_realign_packet(tu_fifo_t *ff, uint16_t n_received, uint8_t sample_bytes);
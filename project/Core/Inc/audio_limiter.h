@@ -0,0 +1,74 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_pipeline.h"
+
+// Look-ahead peak limiter in the pipeline after the EQ and the crossfeed (the tone and the dither follow).
+// The signal is delayed by the look-ahead + 1 frames and the gain reaches the required
+// reduction before a peak gets to the output. The peak detector also checks the half sample
+// points (4 tap interpolation), so the inter-sample (true) peaks are caught as well.
+// The gain is stereo linked, held for the look-ahead time and released exponentially.
+// The look-ahead and the release are set in frames for the sample rate (power of 2 look-ahead).
+//
+// The tone control (the codec's or audio_tone.c) boosts after the limiter, so the ceiling is lowered
+// by the max boost instead of lowering the whole signal by it (master volume). The quiet content keeps its level.
+
+#define AUDIO_LIMITER_LOOKAHEAD_US      1333  // 64 frames at 48kHz
+#define AUDIO_LIMITER_RELEASE_US       42667  // time constant, 2048 frames at 48kHz
+#define AUDIO_LIMITER_MAX_LOOKAHEAD      128  // frames, 96kHz
+
+void audio_limiter_init(uint32_t sample_rate);
+
+// the look-ahead and the release for the new rate, see AudioStage.set_sample_rate
+void audio_limiter_set_sample_rate(uint32_t sample_rate);
+
+// the output never exceeds this level (<= 0), dB x10
+void audio_limiter_set_ceiling_db_x10(int16_t ceiling);
+
+// the max gain reduction since the last call, dB x10 (positive, 0 is no limiting)
+// the meter is read and cleared with the IRQs off, the refill may update it any time
+int16_t audio_limiter_get_reduction_db_x10(void);
+
+// call from the main loop, checks the codec's overflow flags while streaming (a short I2C read)
+void audio_limiter_task(void);
+
+void audio_limiter_process(int32_t *buf, uint16_t n_frames);
+
+extern AudioStage audio_limiter_stage;
+
+typedef struct {
+	uint32_t limited_blocks; // blocks where the gain was below unity
+	uint32_t codec_clips;    // times the codec reported an overflow
+} AudioLimiterStats;
+
+extern AudioLimiterStats audio_limiter_stats;
+
+// prints the DWT cycles per sample of one block, with and without limiting
+void audio_limiter_benchmark(void);
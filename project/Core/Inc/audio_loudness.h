@@ -0,0 +1,61 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_pipeline.h"
+
+// Loudness compensation: a low and a high shelf which follow the equal-loudness contours
+// as the volume goes down. The filters are taken from loudness_table.h (tools/loudness-table.py)
+// for every 0.5dB volume step, so a volume change is only a table lookup.
+// The filters never boost, they are lowered by their max boost (makeup) and the stage gives it back
+// with its own gain, smoothed per sample like the digital volume. So the makeup changes together
+// with the filters, without a codec write. The digital volume before the stage has to leave
+// the makeup as headroom (see audio_volume_set_headroom_db_x10()).
+
+// false when the table was generated for another sample rate, then it can't be enabled
+bool audio_loudness_init(uint32_t sample_rate);
+
+// at another rate than the table's the stage is off, the UI switch is kept for the return
+void audio_loudness_set_sample_rate(uint32_t sample_rate);
+
+// the stage is bypassed (crossfaded) when off
+void audio_loudness_enable(bool enable);
+
+// the volume without the balance, dB x10 (<= 0)
+void audio_loudness_set_volume_db_x10(int16_t volume);
+
+// the makeup the stage applies at the volume (without the balance) when the loudness is on, otherwise 0
+int16_t audio_loudness_get_makeup_db_x10(int16_t volume);
+
+// clears the filter states, the makeup gain starts from unity (the headroom is not there yet at the enable)
+void audio_loudness_reset(void);
+
+void audio_loudness_process(int32_t *buf, uint16_t n_frames);
+
+extern AudioStage audio_loudness_stage;
@@ -0,0 +1,59 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Lock-free handover of a parameter block (e.g. filter coefficients) from the main loop to the refill.
+// There are two copies: the refill reads the published one, the main loop writes the other one and
+// publishes it with a single index flip (release store), the refill picks it up at its next block
+// (acquire load). Neither side waits, and the refill never sees a half written block.
+// Only one writer (the main loop, USB control callbacks included) and one reader (the refill) are allowed.
+// The refill may use the block only within its call, the main loop can overwrite the other copy after that.
+
+typedef struct {
+	uint8_t *copy[2];
+	uint16_t size;
+	volatile uint8_t front;  // index of the published copy
+	volatile uint8_t seq;    // incremented by every publish
+	uint8_t taken;           // the last 'seq' seen by the refill
+	bool editing;            // the back copy is already up to date with the front one
+} AudioParams;
+
+// 'a' is the initial content, it is copied to 'b'
+void audio_params_init(AudioParams *p, void *a, void *b, uint16_t size);
+
+// main loop: the back copy, with the content of the published one at the first call after a publish
+void* audio_params_edit(AudioParams *p);
+
+// main loop: makes the edited copy the published one
+void audio_params_publish(AudioParams *p);
+
+// refill: the published copy, 'changed' is set when there was a publish since the last call
+const void* audio_params_take(AudioParams *p, bool *changed);
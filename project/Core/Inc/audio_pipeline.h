@@ -0,0 +1,82 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Chain of DSP stages in the refill, between the FIFO read and the I2S DMA buffer.
+// The period is decoded from the I2S frames to Q31 stereo (in place), goes through the enabled stages
+// in the order they were added and is packed back. The stages work on blocks of max AUDIO_PIPELINE_BLOCK_FRAMES.
+// Enable/bypass is taken over at the next block boundary with a 1 block linear crossfade between
+// the processed and the bypassed signal, so it is click free.
+// When no stage has anything to do the refill skips the decode/pack as well.
+
+#define AUDIO_PIPELINE_BLOCK_FRAMES  48
+#define AUDIO_PIPELINE_MAX_STAGES     8
+
+typedef struct {
+	const char *name;
+	// in place, 'n_frames' interleaved stereo Q31 samples
+	void (*process)(int32_t *buf, uint16_t n_frames);
+	// optional, false when the stage has nothing to do at the moment (e.g. all EQ bands off), it is skipped then
+	bool (*active)(void);
+	// optional, clears the stage state before it runs again after skipped blocks (disabled or not active)
+	void (*reset)(void);
+	// optional, redesigns the stage for a new sample rate, called only while the stream is stopped
+	void (*set_sample_rate)(uint32_t sample_rate);
+
+	volatile bool enable_req; // written by audio_pipeline_enable(), the initial value is the state after add
+	bool enabled;             // used by the refill
+	bool idle;                // did not run in the last block, its state is stale
+
+	uint32_t cycles;          // DWT cycles of the last block
+	uint32_t cycles_max;
+} AudioStage;
+
+void audio_pipeline_init(void);
+
+// appends the stage to the end of the chain (before the pack), call only before the streaming starts
+bool audio_pipeline_add(AudioStage *stage);
+
+// takes effect at the next block
+void audio_pipeline_enable(AudioStage *stage, bool enable);
+
+// passes the new rate to the stages, call only while the stream is stopped (the refill does not run them)
+void audio_pipeline_set_sample_rate(uint32_t sample_rate);
+
+// clears the state (delay lines, filters, gains) of every stage, call only while the stream is stopped
+void audio_pipeline_reset(void);
+
+// true when at least one stage is (or is being) enabled and active
+bool audio_pipeline_active(void);
+
+// decode, all stages, pack, in place on the I2S frames of the period
+void audio_pipeline_process(uint32_t *frames, uint16_t n_frames);
+
+// prints the cycles of each stage (last block / max), and clears the max
+void audio_pipeline_print_stats(void);
@@ -0,0 +1,68 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Adaptive pre-roll: playback starts when 'preroll' packets are in the USB FIFO.
+// A well behaved host gets the smallest pre-roll (latency), a jittery one (e.g. the USB-C dock case
+// in tud_audio_rx_done_isr()) gets more. A pre-roll is only used when it did not underrun (or nearly
+// underrun, see audio_preroll_update()) in the last PREROLL_WINDOW_MS and it covers the packet arrival
+// jitter seen in the last window.
+// No HAL in here, the packet timing and the underruns come from usb_handler.c, so the decision
+// can be replayed on a PC (see tools/preroll_test.c).
+#define PREROLL_MIN           2 // packets
+#define PREROLL_MAX           8 // packets, the FIFO is 12 packets
+#define PREROLL_DEFAULT       4 // packets
+#define PREROLL_WINDOW_MS 10000
+
+typedef struct {
+	uint8_t preroll;          // current start threshold in packets
+	uint32_t underruns;       // short reads while the host was still streaming
+	uint32_t near_underruns;  // packets which found the FIFO (almost) empty while playing
+	uint16_t fifo_min;        // FIFO fill in bytes right after a packet, since the playback started
+	uint32_t jitter_max_us;   // max deviation from the 1ms packet interval in the last window
+} PrerollStats;
+
+// global so it can be watched in the debugger
+extern PrerollStats preroll_stats;
+
+// forgets the jitter and the underruns (a new host), the pre-roll is PREROLL_DEFAULT again
+void audio_preroll_reset(void);
+
+// called from the USB ISR for every packet, after it was written to the FIFO
+// interval_us - time since the previous packet, fill - FIFO fill in bytes, playing - the I2S reads the FIFO
+void audio_preroll_packet(uint32_t interval_us, uint16_t fill, bool playing);
+
+// called when the playback starts (the FIFO reached the pre-roll)
+void audio_preroll_started(void);
+
+// picks the pre-roll for the next start, called every ms
+// underrun - a refill got less than a period while the host was still streaming
+// packet_len - bytes of the nominal packet of the played format
+void audio_preroll_update(uint32_t curr_ms, bool underrun, uint16_t packet_len);
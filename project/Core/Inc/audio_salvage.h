@@ -0,0 +1,50 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#pragma once
+
+#include <stdint.h>
+
+// Recovery of USB packets which are not a multiple of the 6 byte stereo frame.
+// Somewhere in such a packet bytes were lost (or inserted), from there on the frames are shifted.
+// The split point is searched where the aligned prefix + the realigned rest is the smoothest signal,
+// the frame at the split is replaced by an interpolated one. The next packet starts aligned again.
+// Portable C, there is no HW or tinyUSB access in it.
+
+typedef struct {
+	uint32_t packets;   // misaligned packets
+	uint32_t tail;      // broken at the end, the aligned prefix is kept
+	uint32_t head;      // broken at the start, the whole packet is realigned
+	uint32_t split;     // broken in the middle, prefix kept and the rest realigned
+	uint32_t dropped;   // too short to salvage anything
+} AudioSalvageStats;
+
+extern AudioSalvageStats audio_salvage_stats;
+
+// 'src' is the misaligned packet of 'n' bytes (24bit stereo), 'dst' has to hold n + 6 bytes
+// 'prev_frame' is the last frame before the packet (NULL if there is none)
+// returns the length of the salvaged data in 'dst', always whole frames
+uint16_t audio_salvage_packet(uint8_t *dst, const uint8_t *src, uint16_t n, const uint8_t *prev_frame);
@@ -0,0 +1,57 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_pipeline.h"
+
+// Bass/treble in software instead of the codec's tone control. Every UI step
+// (gain x frequency preset) is precomputed in tone_table.h (tools/tone-table.py),
+// so a change is only a pointer swap which the refill takes over at the next block.
+// The stage goes after the limiter, the same place where the codec's tone control is,
+// so the limiter ceiling (lowered by the max boost) works for both.
+
+// false when the table was generated for another sample rate, the codec tone control has to be used then
+bool audio_tone_init(uint32_t sample_rate);
+
+// the stage is off at another rate than the table's, see audio_tone_available()
+void audio_tone_set_sample_rate(uint32_t sample_rate);
+
+// false at another rate than the table's
+bool audio_tone_available(void);
+
+// gains are dB x10 (the UI steps), 'freq_id' is the preset index
+void audio_tone_set_bass(uint8_t freq_id, int16_t gain_db_x10);
+void audio_tone_set_treble(uint8_t freq_id, int16_t gain_db_x10);
+
+// clears the filter states, the pipeline calls it when the stage becomes active again (after flat)
+void audio_tone_reset(void);
+
+void audio_tone_process(int32_t *buf, uint16_t n_frames);
+
+extern AudioStage audio_tone_stage;
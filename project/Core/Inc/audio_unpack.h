@@ -0,0 +1,71 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Converters from the USB sample format to the I2S DMA buffer format.
+// The I2S is set to 24bit data in a 32bit frame, and it is fed by a 16bit DMA,
+// so each sample is 2x 16bit where the more significant half word goes first.
+// Mapping of one sample (see also the comment in unpack_24_to_i2s_ref()):
+//   USB   array:  0, 1, 2 -> LSB, MID, MSB
+//   I2S   array:  MSB[ LSB,  MSB  ] + LSB[ LSB, MSB  ]
+//   e.g.          MSB[ USB1, USB2 ] + LSB[   0, USB0 ]
+//
+// 'dst' has to be 4 byte aligned, 'src' can be unaligned, 'n' is the number of samples (not frames)
+
+// byte wise reference implementation (this was the original loop in loadMore())
+void unpack_24_to_i2s_ref(uint8_t *dst, const uint8_t *src, uint16_t n);
+
+// word wide implementation, reads 4 samples (12 bytes) as 3 words and writes 4 words
+void unpack_24_to_i2s(uint8_t *dst, const uint8_t *src, uint16_t n);
+
+// 16bit samples (2 bytes), a widening copy: the sample is simply the less significant half word of the frame
+// reads 4 samples (8 bytes) as 2 words and writes 4 words
+void unpack_16_to_i2s(uint8_t *dst, const uint8_t *src, uint16_t n);
+
+// 24bit samples in 4 bytes (left aligned, the lowest byte is padding), a copy with a half word swap
+void unpack_32_to_i2s(uint8_t *dst, const uint8_t *src, uint16_t n);
+
+typedef void (*AudioUnpackFunc)(uint8_t *dst, const uint8_t *src, uint16_t n);
+
+// the kernel for the USB subslot size (2, 3 or 4 bytes), NULL for other sizes
+AudioUnpackFunc unpack_get_kernel(uint8_t bytes_per_sample);
+
+// prints the DWT cycle count of the reference and the word wide 24bit kernel, and of the 16 and 32bit kernels
+void unpack_benchmark(void);
+
+// one I2S frame (as it is in the DMA buffer) to a left aligned 24bit sample (Q31) and back
+static inline int32_t i2s_frame_to_q31(uint32_t frame) {
+	return (int32_t)((frame >> 16) | (frame << 16));
+}
+
+static inline uint32_t q31_to_i2s_frame(int32_t sample) {
+	const uint32_t s = (uint32_t)sample & 0xFFFFFF00;
+	return (s >> 16) | (s << 16);
+}
@@ -0,0 +1,67 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_pipeline.h"
+
+// Digital volume/balance stage in the refill pipeline, with a per sample 1-pole smoothed gain.
+// The codec HP volume takes only the coarse part of the attenuation (AUDIO_VOLUME_COARSE_DB_X10 steps),
+// the rest is done digitally in 0.1dB steps. While streaming the codec is written only when the digital
+// range is not enough (immediately when the volume goes above the codec setting,
+// after a settle time when it goes below the digital range) and when the stream becomes idle.
+// The deferred writes move the codec down by one coarse step at a time, AUDIO_VOLUME_STEP_MS apart,
+// so the codec and the digital gain are never off from each other by more than one coarse step.
+// This way a volume slider burst from the host is (mostly) no I2C traffic at all.
+
+// all dB values are x10, like in audio_controls.c
+#define AUDIO_VOLUME_COARSE_DB_X10    60  // codec steps
+#define AUDIO_VOLUME_DIGITAL_DB_X10  240  // max digital attenuation on top of the codec
+#define AUDIO_VOLUME_SETTLE_MS       200  // no change for this long before a deferred codec write
+#define AUDIO_VOLUME_STEP_MS          10  // between the deferred coarse steps, ~4 smoothing time constants
+
+void audio_volume_init(void);
+
+// the total L and R attenuation (volume with the balance), <= 0
+void audio_volume_set_db_x10(int16_t vol_l, int16_t vol_r);
+
+// the codec is kept this much above the volume, so the digital part leaves the headroom for a gain
+// of a later stage (the loudness makeup), >= 0. Takes effect with the next audio_volume_set_db_x10().
+void audio_volume_set_headroom_db_x10(int16_t headroom);
+
+// call from the main loop, does the deferred and the idle codec writes
+void audio_volume_task(void);
+
+extern AudioStage audio_volume_stage;
+
+typedef struct {
+	uint32_t requests;      // audio_volume_set_db_x10() calls
+	uint32_t codec_writes;  // times the codec HP volume was written
+} AudioVolumeStats;
+
+extern AudioVolumeStats audio_volume_stats;
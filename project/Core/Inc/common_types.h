@@ -46,6 +46,10 @@ typedef struct
     uint16_t fifo_size;
     uint16_t fifo_count;
     uint16_t fifo_count_avg;
+    uint32_t short_reads;
+    uint32_t overruns;
+    int16_t limiter_reduction; // max gain reduction since the last report, dB x10
+    uint16_t codec_clips;
   } audio_debug_info_t;
 #endif
 
@@ -0,0 +1,25 @@
+// Generated by tools/i2s-clock-calc.py --rate-table, do not edit
+// HSE=8000000Hz, the closest PLLI2S/I2SPR configuration for each sample rate
+
+#pragma once
+
+#include <stdint.h>
+
+typedef struct {
+	uint32_t sample_rate;
+	uint8_t plli2s_m;
+	uint16_t plli2s_n;
+	uint8_t plli2s_r;
+	uint8_t i2s_div;
+	uint8_t i2s_odd;
+	int16_t ppm_x10;    // offset from the sample rate in 0.1ppm
+} I2sRateConfig;
+
+#define I2S_RATE_TABLE_LEN       4
+
+static const I2sRateConfig i2s_rate_table[I2S_RATE_TABLE_LEN] = {
+	{ 44100,  7, 326, 3,   5, 1,    393 }, // 44101.732Hz
+	{ 48000,  5, 192, 5,   2, 1,      0 }, // 48000.000Hz
+	{ 88200,  5, 254, 3,   3, 0,   -630 }, // 88194.444Hz
+	{ 96000,  4, 172, 2,   3, 1,  -1860 }, // 95982.143Hz
+};
@@ -0,0 +1,343 @@
+// Generated by tools/loudness-table.py, do not edit
+// fs=48000Hz, reference 83 phon at 0dB, low shelf 100Hz, high shelf 10000Hz
+
+#pragma once
+
+#include <stdint.h>
+#include "audio_biquad.h"
+
+typedef struct {
+	AudioBiquadQ31Coef low;   // low shelf, already lowered by the makeup
+	AudioBiquadQ31Coef high;  // high shelf
+	int16_t makeup_db_x10;    // max boost of the pair, the stage gain after the filters
+} LoudnessEntry;
+
+#define LOUDNESS_TABLE_FS        48000
+#define LOUDNESS_TABLE_LEN       161
+#define LOUDNESS_STEP_DB_X10     5
+
+// index: -volume / LOUDNESS_STEP_DB_X10
+static const LoudnessEntry loudness_table[LOUDNESS_TABLE_LEN] = {
+	{ {  1073741824, -2127604139,  1054044608,  2127604139, -1054044608, 1 },
+	  {  1073741824,  -330226623,   202155872,   330226623,  -202155872, 1 },    0 }, //   0.0dB: bass + 0.0dB, treble +0.0dB
+	{ {  1050350600, -2081146895,  1030976591,  2127713799, -1054152271, 1 },
+	  {  1079667082,  -334986071,   203594195,   327304212,  -201837594, 1 },    2 }, //  -0.5dB: bass + 0.2dB, treble +0.1dB
+	{ {  1027476485, -2035718444,  1008420281,  2127822819, -1054259317, 1 },
+	  {  1085621102,  -339783409,   205044012,   324382357,  -201522237, 1 },    4 }, //  -1.0dB: bass + 0.4dB, treble +0.2dB
+	{ {  1005108108, -1991296133,   986364395,  2127931200, -1054365746, 1 },
+	  {  1091603878,  -344618749,   206505374,   321461129,  -201209808, 1 },    6 }, //  -1.5dB: bass + 0.6dB, treble +0.2dB
+	{ {   983234348, -1947857806,   964797898,  2128038945, -1054471562, 1 },
+	  {  1097615400,  -349492196,   207978330,   318540600,  -200900310, 1 },    8 }, //  -2.0dB: bass + 0.8dB, treble +0.3dB
+	{ {   961844328, -1905381796,   943710001,  2128146059, -1054576767, 1 },
+	  {  1103655652,  -354403852,   209462927,   315620846,  -200593750, 1 },   10 }, //  -2.5dB: bass + 1.0dB, treble +0.4dB
+	{ {   940927412, -1863846917,   923090151,  2128252542, -1054681364, 1 },
+	  {  1109724612,  -359353809,   210959210,   312701942,  -200290131, 1 },   12 }, //  -3.0dB: bass + 1.2dB, treble +0.5dB
+	{ {   920473198, -1823232447,   902928030,  2128358399, -1054785355, 1 },
+	  {  1115822250,  -364342158,   212467223,   309783968,  -199989458, 1 },   13 }, //  -3.5dB: bass + 1.3dB, treble +0.6dB
+	{ {   900471513, -1783518123,   883213546,  2128463631, -1054888743, 1 },
+	  {  1121948530,  -369368979,   213987008,   306867003,  -199691737, 1 },   15 }, //  -4.0dB: bass + 1.5dB, treble +0.7dB
+	{ {   880912408, -1744684127,   863936831,  2128568241, -1054991530, 1 },
+	  {  1128103409,  -374434348,   215518604,   303951129,  -199396970, 1 },   17 }, //  -4.5dB: bass + 1.7dB, treble +0.7dB
+	{ {   861786156, -1706711081,   845088236,  2128672233, -1055093719, 1 },
+	  {  1134286837,  -379538331,   217062051,   301036432,  -199105164, 1 },   19 }, //  -5.0dB: bass + 1.9dB, treble +0.8dB
+	{ {   843083239, -1669580034,   826658322,  2128775608, -1055195311, 1 },
+	  {  1140498755,  -384680990,   218617383,   298122998,  -198816321, 1 },   21 }, //  -5.5dB: bass + 2.1dB, treble +0.9dB
+	{ {   824794355, -1633272451,   808637861,  2128878369, -1055296310, 1 },
+	  {  1146739099,  -389862377,   220184634,   295210915,  -198530447, 1 },   23 }, //  -6.0dB: bass + 2.3dB, treble +1.0dB
+	{ {   806910403, -1597770210,   791017830,  2128980519, -1055396718, 1 },
+	  {  1153007794,  -395082537,   221763836,   292300276,  -198247545, 1 },   25 }, //  -6.5dB: bass + 2.5dB, treble +1.1dB
+	{ {   789422484, -1563055585,   773789402,  2129082059, -1055496536, 1 },
+	  {  1159304758,  -400341504,   223355016,   289391174,  -197967620, 1 },   27 }, //  -7.0dB: bass + 2.7dB, treble +1.2dB
+	{ {   772321896, -1529111245,   756943948,  2129182994, -1055595768, 1 },
+	  {  1165629898,  -405639307,   224958203,   286483704,  -197690674, 1 },   29 }, //  -7.5dB: bass + 2.9dB, treble +1.2dB
+	{ {   755600127, -1495920240,   740473028,  2129283324, -1055694415, 1 },
+	  {  1171983115,  -410975962,   226573418,   283577966,  -197416713, 1 },   31 }, //  -8.0dB: bass + 3.1dB, treble +1.3dB
+	{ {   739248855, -1463465994,   724368389,  2129383053, -1055792479, 1 },
+	  {  1178364298,  -416351479,   228200683,   280674060,  -197145738, 1 },   33 }, //  -8.5dB: bass + 3.3dB, treble +1.4dB
+	{ {   723259941, -1431732298,   708621962,  2129482182, -1055889963, 1 },
+	  {  1184773328,  -421765854,   229840016,   277772090,  -196877755, 1 },   34 }, //  -9.0dB: bass + 3.4dB, treble +1.5dB
+	{ {   707625425, -1400703301,   693225854,  2129580714, -1055986868, 1 },
+	  {  1191210073,  -427219076,   231491430,   274872164,  -196612766, 1 },   36 }, //  -9.5dB: bass + 3.6dB, treble +1.6dB
+	{ {   692337522, -1370363501,   678172349,  2129678651, -1056083198, 1 },
+	  {  1197674392,  -432711121,   233154938,   271974390,  -196350774, 1 },   38 }, // -10.0dB: bass + 3.8dB, treble +1.6dB
+	{ {   677388622, -1340697740,   663453899,  2129775996, -1056178953, 1 },
+	  {  1204166134,  -438241954,   234830547,   269078880,  -196091783, 1 },   40 }, // -10.5dB: bass + 4.0dB, treble +1.7dB
+	{ {   662771279, -1311691195,   649063125,  2129872750, -1056274135, 1 },
+	  {  1210685135,  -443811528,   236518261,   266185751,  -195835795, 1 },   42 }, // -11.0dB: bass + 4.2dB, treble +1.8dB
+	{ {   648478215, -1283329370,   634992812,  2129968916, -1056368748, 1 },
+	  {  1217231218,  -449419784,   238218083,   263295120,  -195582813, 1 },   44 }, // -11.5dB: bass + 4.4dB, treble +1.9dB
+	{ {   634502309, -1255598091,   621235902,  2130064495, -1056462792, 1 },
+	  {  1223804196,  -455066650,   239930007,   260407110,  -195332840, 1 },   46 }, // -12.0dB: bass + 4.6dB, treble +2.0dB
+	{ {   620836602, -1228483495,   607785495,  2130159491, -1056556269, 1 },
+	  {  1230403869,  -460752040,   241654028,   257521845,  -195085877, 1 },   48 }, // -12.5dB: bass + 4.8dB, treble +2.1dB
+	{ {   607474285, -1201972027,   594634844,  2130253904, -1056649181, 1 },
+	  {  1237030020,  -466475855,   243390133,   254639454,  -194841928, 1 },   50 }, // -13.0dB: bass + 5.0dB, treble +2.1dB
+	{ {   594408700, -1176050433,   581777351,  2130347737, -1056741531, 1 },
+	  {  1243682423,  -472237980,   245138308,   251760068,  -194600994, 1 },   52 }, // -13.5dB: bass + 5.2dB, treble +2.2dB
+	{ {   581633338, -1150705750,   569206564,  2130440991, -1056833319, 1 },
+	  {  1250360834,  -478038287,   246898530,   248883823,  -194363077, 1 },   53 }, // -14.0dB: bass + 5.3dB, treble +2.3dB
+	{ {   569141833, -1125925304,   556916174,  2130533669, -1056924548, 1 },
+	  {  1257064997,  -483876629,   248670776,   246010859,  -194128179, 1 },   55 }, // -14.5dB: bass + 5.5dB, treble +2.4dB
+	{ {   556927959, -1101696701,   544900012,  2130625773, -1057015218, 1 },
+	  {  1263794637,  -489752845,   250455015,   243141318,  -193896301, 1 },   57 }, // -15.0dB: bass + 5.7dB, treble +2.5dB
+	{ {   544985629, -1078007822,   533152046,  2130717303, -1057105333, 1 },
+	  {  1270549466,  -495666757,   252251211,   240275348,  -193667444, 1 },   59 }, // -15.5dB: bass + 5.9dB, treble +2.5dB
+	{ {   533308889, -1054846814,   521666378,  2130808263, -1057194892, 1 },
+	  {  1277329179,  -501618167,   254059323,   237413100,  -193441610, 1 },   61 }, // -16.0dB: bass + 6.1dB, treble +2.6dB
+	{ {   521891920, -1032202090,   510437240,  2130898652, -1057283898, 1 },
+	  {  1284133452,  -507606862,   255879305,   234554728,  -193218799, 1 },   63 }, // -16.5dB: bass + 6.3dB, treble +2.7dB
+	{ {   510729028, -1010062318,   499458992,  2130988474, -1057372353, 1 },
+	  {  1290961944,  -513632606,   257711105,   231700393,  -192999012, 1 },   65 }, // -17.0dB: bass + 6.5dB, treble +2.8dB
+	{ {   499814648,  -988416418,   488726121,  2131077730, -1057460257, 1 },
+	  {  1297814296,  -519695145,   259554663,   228850259,  -192782249, 1 },   67 }, // -17.5dB: bass + 6.7dB, treble +2.9dB
+	{ {   489143337,  -967253555,   478233233,  2131166420, -1057547611, 1 },
+	  {  1304690129,  -525794203,   261409914,   226004494,  -192568510, 1 },   69 }, // -18.0dB: bass + 6.9dB, treble +2.9dB
+	{ {   478709773,  -946563136,   467975058,  2131254548, -1057634419, 1 },
+	  {  1311589045,  -531929485,   263276787,   223163273,  -192357796, 1 },   70 }, // -18.5dB: bass + 7.0dB, treble +3.0dB
+	{ {   468508751,  -926334802,   457946441,  2131342113, -1057720679, 1 },
+	  {  1318510624,  -538100671,   265155202,   220326774,  -192150105, 1 },   72 }, // -19.0dB: bass + 7.2dB, treble +3.1dB
+	{ {   458535185,  -906558425,   448142341,  2131429118, -1057806394, 1 },
+	  {  1325454425,  -544307417,   267045074,   217495180,  -191945437, 1 },   74 }, // -19.5dB: bass + 7.4dB, treble +3.2dB
+	{ {   448784097,  -887224101,   438557829,  2131515564, -1057891566, 1 },
+	  {  1332419985,  -550549358,   268946309,   214668679,  -191743790, 1 },   76 }, // -20.0dB: bass + 7.6dB, treble +3.3dB
+	{ {   439250624,  -868322146,   429188089,  2131601451, -1057976194, 1 },
+	  {  1339406817,  -556826101,   270858805,   211847468,  -191545165, 1 },   78 }, // -20.5dB: bass + 7.8dB, treble +3.3dB
+	{ {   429930008,  -849843094,   420028408,  2131686782, -1058060280, 1 },
+	  {  1346414413,  -563137226,   272782452,   209031744,  -191349559, 1 },   80 }, // -21.0dB: bass + 8.0dB, treble +3.4dB
+	{ {   420817597,  -831777686,   411074181,  2131771557, -1058143825, 1 },
+	  {  1353442236,  -569482290,   274717133,   206221714,  -191156969, 1 },   82 }, // -21.5dB: bass + 8.2dB, treble +3.5dB
+	{ {   411908846,  -814116873,   402320904,  2131855777, -1058226829, 1 },
+	  {  1360489727,  -575860817,   276662720,   203417588,  -190967395, 1 },   84 }, // -22.0dB: bass + 8.4dB, treble +3.6dB
+	{ {   403199306,  -796851805,   393764174,  2131939444, -1058309295, 1 },
+	  {  1367556298,  -582272304,   278619077,   200619586,  -190780833, 1 },   85 }, // -22.5dB: bass + 8.5dB, treble +3.6dB
+	{ {   394684632,  -779973831,   385399688,  2132022558, -1058391222, 1 },
+	  {  1374641335,  -588716218,   280586058,   197827930,  -190597281, 1 },   87 }, // -23.0dB: bass + 8.7dB, treble +3.7dB
+	{ {   386360572,  -763474492,   377223236,  2132105120, -1058472612, 1 },
+	  {  1381744193,  -595191993,   282563507,   195042852,  -190416735, 1 },   89 }, // -23.5dB: bass + 8.9dB, treble +3.8dB
+	{ {   378222971,  -747345518,   369230705,  2132187131, -1058553464, 1 },
+	  {  1388864201,  -601699030,   284551257,   192264587,  -190239191, 1 },   91 }, // -24.0dB: bass + 9.1dB, treble +3.9dB
+	{ {   370267766,  -731578825,   361418071,  2132268592, -1058633780, 1 },
+	  {  1396000653,  -608236697,   286549132,   189493382,  -190064647, 1 },   93 }, // -24.5dB: bass + 9.3dB, treble +4.0dB
+	{ {   362490986,  -716166510,   353781404,  2132349503, -1058713560, 1 },
+	  {  1403152816,  -614804325,   288556944,   186729486,  -189893096, 1 },   95 }, // -25.0dB: bass + 9.5dB, treble +4.0dB
+	{ {   354888748,  -701100844,   346316860,  2132429865, -1058792804, 1 },
+	  {  1410319919,  -621401211,   290574492,   183973159,  -189724535, 1 },   97 }, // -25.5dB: bass + 9.7dB, treble +4.1dB
+	{ {   347457255,  -686374275,   339020680,  2132509678, -1058871513, 1 },
+	  {  1417501161,  -628026610,   292601564,   181224668,  -189558958, 1 },   98 }, // -26.0dB: bass + 9.8dB, treble +4.2dB
+	{ {   340192796,  -671979420,   331889192,  2132588943, -1058949688, 1 },
+	  {  1424695703,  -634679741,   294637936,   178484286,  -189396360, 1 },  100 }, // -26.5dB: bass +10.0dB, treble +4.3dB
+	{ {   333091745,  -657909059,   324918805,  2132667661, -1059027328, 1 },
+	  {  1431902670,  -641359779,   296683370,   175752297,  -189236734, 1 },  102 }, // -27.0dB: bass +10.2dB, treble +4.3dB
+	{ {   326150555,  -644156138,   318106009,  2132745831, -1059104433, 1 },
+	  {  1439121150,  -648065857,   298737614,   173028992,  -189080075, 1 },  104 }, // -27.5dB: bass +10.4dB, treble +4.4dB
+	{ {   319365759,  -630713760,   311447375,  2132823454, -1059181004, 1 },
+	  {  1446350189,  -654797066,   300800405,   170314670,  -188926374, 1 },  106 }, // -28.0dB: bass +10.6dB, treble +4.5dB
+	{ {   312733970,  -617575183,   304939549,  2132900529, -1059257041, 1 },
+	  {  1453588796,  -661552449,   302871460,   167609642,  -188775625, 1 },  108 }, // -28.5dB: bass +10.8dB, treble +4.6dB
+	{ {   306251877,  -604733821,   298579254,  2132977058, -1059332544, 1 },
+	  {  1460835934,  -668331001,   304950486,   164914224,  -188627819, 1 },  109 }, // -29.0dB: bass +10.9dB, treble +4.6dB
+	{ {   299916241,  -592183232,   292363287,  2133053039, -1059407511, 1 },
+	  {  1468090525,  -675131669,   307037170,   162228746,  -188482948, 1 },  111 }, // -29.5dB: bass +11.1dB, treble +4.7dB
+	{ {   293723901,  -579917124,   286288519,  2133128472, -1059481944, 1 },
+	  {  1475351443,  -681953348,   309131187,   159553545,  -188341003, 1 },  113 }, // -30.0dB: bass +11.3dB, treble +4.8dB
+	{ {   287671764,  -567929346,   280351889,  2133203358, -1059555842, 1 },
+	  {  1482617517,  -688794879,   311232191,   156888970,  -188201975, 1 },  115 }, // -30.5dB: bass +11.5dB, treble +4.9dB
+	{ {   281756809,  -556213888,   274550410,  2133277696, -1059629204, 1 },
+	  {  1489887527,  -695655050,   313339820,   154235379,  -188065853, 1 },  117 }, // -31.0dB: bass +11.7dB, treble +4.9dB
+	{ {   275976084,  -544764876,   268881159,  2133351486, -1059702029, 1 },
+	  {  1497160202,  -702532590,   315453694,   151593144,  -187932626, 1 },  119 }, // -31.5dB: bass +11.9dB, treble +5.0dB
+	{ {   270326704,  -533576572,   263341283,  2133424726, -1059774317, 1 },
+	  {  1504434218,  -709426171,   317573414,   148962647,  -187802284, 1 },  120 }, // -32.0dB: bass +12.0dB, treble +5.1dB
+	{ {   264805849,  -522643367,   257927994,  2133497416, -1059846068, 1 },
+	  {  1511708198,  -716334400,   319698560,   146344280,  -187674813, 1 },  122 }, // -32.5dB: bass +12.2dB, treble +5.2dB
+	{ {   259410766,  -511959785,   252638566,  2133569556, -1059917280, 1 },
+	  {  1518980709,  -723255824,   321828692,   143738450,  -187550203, 1 },  124 }, // -33.0dB: bass +12.4dB, treble +5.2dB
+	{ {   254138764,  -501520471,   247470339,  2133641144, -1059987952, 1 },
+	  {  1526250258,  -730188921,   323963351,   141145575,  -187428439, 1 },  126 }, // -33.5dB: bass +12.6dB, treble +5.3dB
+	{ {   248987215,  -491320199,   242420711,  2133712180, -1060058083, 1 },
+	  {  1533515295,  -737132104,   326102052,   138566088,  -187309508, 1 },  128 }, // -34.0dB: bass +12.8dB, treble +5.4dB
+	{ {   243953550,  -481353860,   237487145,  2133782662, -1060127672, 1 },
+	  {  1540774205,  -744083712,   328244291,   136000435,  -187193395, 1 },  129 }, // -34.5dB: bass +12.9dB, treble +5.4dB
+	{ {   239035262,  -471616467,   232667158,  2133852589, -1060196717, 1 },
+	  {  1548025309,  -751042012,   330389537,   133449074,  -187080085, 1 },  131 }, // -35.0dB: bass +13.1dB, treble +5.5dB
+	{ {   234229901,  -462103147,   227958329,  2133921959, -1060265218, 1 },
+	  {  1555266861,  -758005194,   332537238,   130912481,  -186969563, 1 },  133 }, // -35.5dB: bass +13.3dB, treble +5.6dB
+	{ {   229535076,  -452809145,   223358293,  2133990771, -1060333171, 1 },
+	  {  1562497047,  -764971371,   334686813,   128391146,  -186861810, 1 },  135 }, // -36.0dB: bass +13.5dB, treble +5.7dB
+	{ {   224948452,  -443729813,   218864739,  2134059023, -1060400576, 1 },
+	  {  1569713978,  -771938572,   336837657,   125885573,  -186756811, 1 },  136 }, // -36.5dB: bass +13.6dB, treble +5.7dB
+	{ {   220467747,  -434860618,   214475412,  2134126713, -1060467430, 1 },
+	  {  1576915694,  -778904743,   338989136,   123396284,  -186654547, 1 },  138 }, // -37.0dB: bass +13.8dB, treble +5.8dB
+	{ {   216090736,  -426197133,   210188113,  2134193840, -1060533732, 1 },
+	  {  1584100157,  -785867742,   341140590,   120923820,  -186555000, 1 },  140 }, // -37.5dB: bass +14.0dB, treble +5.9dB
+	{ {   211815247,  -417735036,   206000691,  2134260400, -1060599478, 1 },
+	  {  1591265247,  -792825336,   343291326,   118468735,  -186458148, 1 },  142 }, // -38.0dB: bass +14.2dB, treble +5.9dB
+	{ {   207639158,  -409470110,   201911051,  2134326392, -1060664667, 1 },
+	  {  1598408764,  -799775197,   345440625,   116031605,  -186363973, 1 },  143 }, // -38.5dB: bass +14.3dB, treble +6.0dB
+	{ {   203560402,  -401398242,   197917146,  2134391813, -1060729296, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  145 }, // -39.0dB: bass +14.5dB, treble +6.0dB
+	{ {   199576959,  -393515416,   194016982,  2134456661, -1060793362, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  147 }, // -39.5dB: bass +14.7dB, treble +6.0dB
+	{ {   195686862,  -385817717,   190208610,  2134520931, -1060856862, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  149 }, // -40.0dB: bass +14.9dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -40.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -41.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -41.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -42.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -42.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -43.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -43.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -44.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -44.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -45.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -45.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -46.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -46.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -47.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -47.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -48.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -48.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -49.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -49.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -50.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -50.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -51.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -51.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -52.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -52.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -53.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -53.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -54.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -54.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -55.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -55.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -56.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -56.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -57.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -57.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -58.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -58.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -59.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -59.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -60.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -60.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -61.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -61.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -62.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -62.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -63.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -63.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -64.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -64.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -65.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -65.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -66.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -66.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -67.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -67.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -68.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -68.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -69.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -69.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -70.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -70.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -71.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -71.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -72.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -72.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -73.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -73.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -74.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -74.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -75.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -75.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -76.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -76.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -77.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -77.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -78.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -78.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -79.0dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -79.5dB: bass +15.0dB, treble +6.0dB
+	{ {   192521883,  -379555183,   187110423,  2134573931, -1060909230, 1 },
+	  {  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 },  150 }, // -80.0dB: bass +15.0dB, treble +6.0dB
+};
@@ -41,6 +41,7 @@ extern "C" {
 
 /* Exported constants --------------------------------------------------------*/
 /* USER CODE BEGIN EC */
+// the rate after the reset, the host can switch it (see audio_set_sample_rate())
 #define AUDIO_SAMPLING_RATE    48000
 /* USER CODE END EC */
 
@@ -0,0 +1,164 @@
+// Generated by tools/tone-table.py, do not edit
+// fs=48000Hz, shelves with Q=0.707
+
+#pragma once
+
+#include "audio_biquad.h"
+
+#define TONE_TABLE_FS            48000
+#define TONE_TABLE_MIN_DB_X10    (-105)
+#define TONE_TABLE_STEP_DB_X10   15
+#define TONE_TABLE_STEPS         16
+#define TONE_TABLE_FREQ_CNT      4
+
+// [frequency preset][(gain - TONE_TABLE_MIN_DB_X10) / TONE_TABLE_STEP_DB_X10]
+static const AudioBiquadQ31Coef tone_bass_table[TONE_TABLE_FREQ_CNT][TONE_TABLE_STEPS] = {
+	{ // 50Hz
+		{  1070696216, -2134065804,  1063394564,  2134036463, -1060378296, 1 }, // -10.5dB
+		{  1071141228, -2134629410,  1063515417,  2134604649, -1060939582, 1 }, //  -9.0dB
+		{  1071581581, -2135169193,  1063617309,  2135148829, -1061477430, 1 }, //  -7.5dB
+		{  1072018092, -2135686133,  1063700425,  2135670017, -1061992808, 1 }, //  -6.0dB
+		{  1072451568, -2136181170,  1063764915,  2136169185, -1062486644, 1 }, //  -4.5dB
+		{  1072882814, -2136655204,  1063810896,  2136647262, -1062959829, 1 }, //  -3.0dB
+		{  1073312633, -2137109096,  1063838451,  2137105139, -1063413217, 1 }, //  -1.5dB
+		{  1073741824, -2137543670,  1063847630,  2137543670, -1063847630, 1 }, //  +0.0dB
+		{  1074171186, -2137959714,  1063838450,  2137963673, -1064263853, 1 }, //  +1.5dB
+		{  1074601521, -2138357980,  1063810894,  2138365929, -1064662642, 1 }, //  +3.0dB
+		{  1075033633, -2138739190,  1063764912,  2138751189, -1065044721, 1 }, //  +4.5dB
+		{  1075468328, -2139104030,  1063700420,  2139120171, -1065410783, 1 }, //  +6.0dB
+		{  1075906422, -2139453158,  1063617303,  2139473563, -1065761496, 1 }, //  +7.5dB
+		{  1076348734, -2139787201,  1063515410,  2139812022, -1066097499, 1 }, //  +9.0dB
+		{  1076796096, -2140106756,  1063394555,  2140136181, -1066419402, 1 }, // +10.5dB
+		{  1077249347, -2140412394,  1063254521,  2140446643, -1066727796, 1 }, // +12.0dB
+	},
+	{ // 100Hz
+		{  1067659406, -2120707233,  1053147104,  2120590599, -1047181320, 1 }, // -10.5dB
+		{  1068547062, -2121825245,  1053386471,  2121726791, -1048290164, 1 }, //  -9.0dB
+		{  1069425790, -2122895982,  1053588305,  2122814993, -1049353261, 1 }, //  -7.5dB
+		{  1070297208, -2123921340,  1053752960,  2123857231, -1050372453, 1 }, //  -6.0dB
+		{  1071162921, -2124903135,  1053880726,  2124855445, -1051349513, 1 }, //  -4.5dB
+		{  1072024531, -2125843105,  1053971826,  2125811493, -1052286144, 1 }, //  -3.0dB
+		{  1072883633, -2126742910,  1054026421,  2126727157, -1053183984, 1 }, //  -1.5dB
+		{  1073741824, -2127604139,  1054044608,  2127604139, -1054044608, 1 }, //  +0.0dB
+		{  1074600701, -2128428308,  1054026417,  2128444074, -1054869528, 1 }, //  +1.5dB
+		{  1075461868, -2129216865,  1053971818,  2129248526, -1055660200, 1 }, //  +3.0dB
+		{  1076326936, -2129971189,  1053880713,  2130018994, -1056418020, 1 }, //  +4.5dB
+		{  1077197526, -2130692597,  1053752944,  2130756912, -1057144331, 1 }, //  +6.0dB
+		{  1078075277, -2131382339,  1053588285,  2131463655, -1057840421, 1 }, //  +7.5dB
+		{  1078961841, -2132041606,  1053386447,  2132140540, -1058507530, 1 }, //  +9.0dB
+		{  1079858893, -2132671529,  1053147075,  2132788827, -1059146846, 1 }, // +10.5dB
+		{  1080768133, -2133273177,  1052869751,  2133409725, -1059759511, 1 }, // +12.0dB
+	},
+	{ // 200Hz
+		{  1061612665, -2094168500,  1032948037,  2093707731, -1021279647, 1 }, // -10.5dB
+		{  1063378433, -2096367872,  1033417464,  2095978716, -1023443229, 1 }, //  -9.0dB
+		{  1065127908, -2098474180,  1033813371,  2098153897, -1025519739, 1 }, //  -7.5dB
+		{  1066864264, -2100490955,  1034136410,  2100237303, -1027512501, 1 }, //  -6.0dB
+		{  1068590667, -2102421574,  1034387110,  2102232797, -1029424730, 1 }, //  -4.5dB
+		{  1070310282, -2104269263,  1034565886,  2104144078, -1031259530, 1 }, //  -3.0dB
+		{  1072026276, -2106037105,  1034673033,  2105974692, -1033019898, 1 }, //  -1.5dB
+		{  1073741824, -2107728036,  1034708726,  2107728036, -1034708726, 1 }, //  +0.0dB
+		{  1075460118, -2109344853,  1034673025,  2109407366, -1036328805, 1 }, //  +1.5dB
+		{  1077184368, -2110890214,  1034565871,  2111015801, -1037882828, 1 }, //  +3.0dB
+		{  1078917812, -2112366640,  1034387087,  2112556327, -1039373388, 1 }, //  +4.5dB
+		{  1080663720, -2113776522,  1034136380,  2114031809, -1040802989, 1 }, //  +6.0dB
+		{  1082425403, -2115122114,  1033813335,  2115444988, -1042174040, 1 }, //  +7.5dB
+		{  1084206214, -2116405543,  1033417423,  2116798492, -1043488864, 1 }, //  +9.0dB
+		{  1086009561, -2117628804,  1032947992,  2118094838, -1044749696, 1 }, // +10.5dB
+		{  1087838912, -2118793766,  1032404273,  2119336437, -1045958690, 1 }, // +12.0dB
+	},
+	{ // 250Hz
+		{  1058602958, -2080988588,  1022994659,  2080273084, -1008571297, 1 }, // -10.5dB
+		{  1060804165, -2083714993,  1023575661,  2083110533, -1011242462, 1 }, //  -9.0dB
+		{  1062985980, -2086325996,  1024065724,  2085828386, -1013807490, 1 }, //  -7.5dB
+		{  1065152335, -2088825845,  1024465627,  2088431663, -1016270320, 1 }, //  -6.0dB
+		{  1067307159, -2091218604,  1024776003,  2090925172, -1018634771, 1 }, //  -4.5dB
+		{  1069454384, -2093508154,  1024997347,  2093313523, -1020904537, 1 }, //  -3.0dB
+		{  1071597952, -2095698194,  1025130012,  2095601137, -1023083197, 1 }, //  -1.5dB
+		{  1073741824, -2097792247,  1025174209,  2097792247, -1025174209, 1 }, //  +0.0dB
+		{  1075889985, -2099793662,  1025130009,  2099890913, -1027180919, 1 }, //  +1.5dB
+		{  1078046453, -2101705613,  1024997341,  2101901024, -1029106559, 1 }, //  +3.0dB
+		{  1080215283, -2103531105,  1024775996,  2103826307, -1030954253, 1 }, //  +4.5dB
+		{  1082400579, -2105272972,  1024465620,  2105670333, -1032727014, 1 }, //  +6.0dB
+		{  1084606501, -2106933881,  1024065720,  2107436525, -1034427753, 1 }, //  +7.5dB
+		{  1086837272, -2108516329,  1023575662,  2109128161, -1036059278, 1 }, //  +9.0dB
+		{  1089097188, -2110022646,  1022994670,  2110748383, -1037624297, 1 }, // +10.5dB
+		{  1091390626, -2111454997,  1022321824,  2112300200, -1039125422, 1 }, // +12.0dB
+	},
+};
+
+static const AudioBiquadQ31Coef tone_treb_table[TONE_TABLE_FREQ_CNT][TONE_TABLE_STEPS] = {
+	{ // 5000Hz
+		{   420611656,  -356805014,   126909594,  1419232103,  -536206516, 1 }, // -10.5dB
+		{   480603232,  -427013250,   151243565,  1389719769,  -520811492, 1 }, //  -9.0dB
+		{   549290828,  -509594961,   180167274,  1359197355,  -505318673, 1 }, //  -7.5dB
+		{   627928743,  -606579007,   214498597,  1327649712,  -489756222, 1 }, //  -6.0dB
+		{   717947296,  -720305380,   255190772,  1295063488,  -474154352, 1 }, //  -4.5dB
+		{   820976224,  -853469294,   303352862,  1261427338,  -458545305, 1 }, //  -3.0dB
+		{   938870923, -1009170900,   360272976,  1226732141,  -442963315, 1 }, //  -1.5dB
+		{  1073741824, -1190971218,   427444542,  1190971218,  -427444542, 1 }, //  +0.0dB
+		{  1227987231, -1402954948,   506595983,  1154140550,  -412026992, 1 }, //  +1.5dB
+		{  1404329956, -1649800872,   599724156,  1116238997,  -396750412, 1 }, //  +3.0dB
+		{  1605858134, -1936860602,   709131940,  1077268508,  -381656155, 1 }, //  +4.5dB
+		{   918035301, -1135123245,   418735203,   518617165,  -183393512, 2 }, //  +6.0dB
+		{  1049463642, -1328464790,   493893004,   498072601,  -176093545, 2 }, //  +7.5dB
+		{  1199452509, -1552424266,   581786643,   477006765,  -168950738, 2 }, //  +9.0dB
+		{  1370529664, -1811515258,   684416793,   455427781,  -161988067, 2 }, // +10.5dB
+		{  1565546326, -2110862560,   804070177,   433345757,  -155228788, 2 }, // +12.0dB
+	},
+	{ // 7000Hz
+		{   464500755,  -215809245,    97510240,  1129613617,  -402073543, 1 }, // -10.5dB
+		{   523310245,  -267865127,   114190967,  1091016476,  -386910737, 1 }, //  -9.0dB
+		{  1179398033,  -658652260,   267946902,  2102706848,  -743915874, 0 }, //  -7.5dB
+		{  1329273009,  -803346416,   314810724,  2021263914,  -714517583, 0 }, //  -6.0dB
+		{  1498423261,  -973193330,   370243521,  1937726362,  -685716166, 0 }, //  -4.5dB
+		{  1689292996, -1172044966,   435714659,  1852123962,  -657603003, 0 }, //  -3.0dB
+		{  1904622960, -1404282983,   512920110,  1764494345,  -630270783, 0 }, //  -1.5dB
+		{  1073741824,  -837441627,   301906480,   837441627,  -301906480, 1 }, //  +0.0dB
+		{  1210655893,  -994743536,   355318672,   791672370,  -289161575, 1 }, //  +1.5dB
+		{  1364975179, -1177239808,   417983055,   744970649,  -276947252, 1 }, //  +3.0dB
+		{  1538846245, -1388538133,   491371261,   697371970,  -265309518, 1 }, //  +4.5dB
+		{  1734664733, -1632708697,   577163162,   648916092,  -254293466, 1 }, //  +6.0dB
+		{  1955101624, -1914336148,   677272274,   599646989,  -243942916, 1 }, //  +7.5dB
+		{  1101565960, -1119288254,   396936850,   274806382,  -117150026, 2 }, //  +9.0dB
+		{  1241032972, -1305609703,   464717414,   249432762,  -112702533, 2 }, // +10.5dB
+		{  1397791736, -1519378025,   543374488,   223730607,  -108647895, 2 }, // +12.0dB
+	},
+	{ // 10000Hz
+		{  1070309877,    46851338,   183920320,  1371610181,  -525208068, 0 }, // -10.5dB
+		{  1181985747,    -8033175,   202719719,  1274299261,  -503487904, 0 }, //  -9.0dB
+		{  1305451365,   -74876393,   224643758,  1175384261,  -483119343, 0 }, //  -7.5dB
+		{  1441941658,  -155493575,   250258086,  1074963340,  -464185862, 0 }, //  -6.0dB
+		{  1592816627,  -251926569,   280217772,   973142590,  -446766773, 0 }, //  -4.5dB
+		{  1759573274,  -366467652,   315278853,   870035686,  -430936513, 0 }, //  -3.0dB
+		{  1943858582,  -501685469,   356311054,   765763433,  -416763952, 0 }, //  -1.5dB
+		{  1073741824,  -330226623,   202155872,   330226623,  -202155872, 1 }, //  +0.0dB
+		{  1186219528,  -422989734,   230210618,   277119270,  -196817857, 1 }, //  +1.5dB
+		{  1310455804,  -530920603,   262969757,   223629019,  -192392153, 1 }, //  +3.0dB
+		{  1447651268,  -656010166,   301172251,   169827517,  -188899046, 1 }, //  +4.5dB
+		{  1599123651,  -800471427,   345655992,   115788287,  -186354679, 1 }, //  +6.0dB
+		{  1766318585,  -966760826,   397368648,    61586297,  -184770880, 1 }, //  +7.5dB
+		{  1950821331, -1157601448,   457379475,     7297512,  -184155047, 1 }, //  +9.0dB
+		{  1077184775,  -688004123,   263446073,   -23500784,   -92255030, 2 }, // +10.5dB
+		{  1189433607,  -812657731,   303629354,   -50617189,   -92917129, 2 }, // +12.0dB
+	},
+	{ // 15000Hz
+		{  1347539255,  1048959431,   378310482,  -253730291,  -373595230, 0 }, // -10.5dB
+		{  1440785695,  1060084723,   387411351,  -361723554,  -379074567, 0 }, //  -9.0dB
+		{  1540249054,  1066227851,   396663207,  -469210998,  -386445466, 0 }, //  -7.5dB
+		{  1646366884,  1066656388,   406180570,  -576046276,  -395673917, 0 }, //  -6.0dB
+		{  1759613190,  1060570326,   416104800,  -682086968,  -406717700, 0 }, //  -4.5dB
+		{  1880501849,  1047096625,   426607367,  -787195375,  -419526818, 0 }, //  -3.0dB
+		{  2009590314,  1025283235,   437893359,  -891239260,  -434044001, 0 }, //  -1.5dB
+		{  1073741824,   497046256,   225102636,  -497046256,  -225102636, 1 }, //  +0.0dB
+		{  1147419448,   476196995,   231913537,  -547817873,  -233970283, 1 }, //  +1.5dB
+		{  1226184920,   449478206,   239544295,  -597878402,  -243587196, 1 }, //  +3.0dB
+		{  1310426077,   416219491,   248185117,  -647175597,  -253913263, 1 }, //  +4.5dB
+		{  1400564499,   375690853,   258054045,  -695661208,  -264906364, 1 }, //  +6.0dB
+		{  1497058546,   327097407,   269399717,  -743291115,  -276522731, 1 }, //  +7.5dB
+		{  1600406651,   269573546,   282504344,  -790025406,  -288717310, 1 }, //  +9.0dB
+		{  1711150900,   202176541,   297686930,  -835828425,  -301444122, 1 }, // +10.5dB
+		{  1829880909,   123879514,   315306776,  -880668771,  -314656604, 1 }, // +12.0dB
+	},
+};
+
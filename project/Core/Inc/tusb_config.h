@@ -94,6 +94,13 @@ extern "C" {
 #define CFG_AUDIO_DEBUG           0
 #endif
 
+// UAC2 on the full speed port instead of UAC1: the host sets the rate on the clock source entity
+// and the volume is in real 1/256dB steps (class compliant on Linux and macOS, Windows 10+ has a UAC2 driver)
+// 0 - UAC1 with the percent mapped volume (USB_MAX_VOLUME_PCT), works with every Windows
+#ifndef CFG_AUDIO_UAC2
+#define CFG_AUDIO_UAC2            0
+#endif
+
 #ifndef CFG_TUD_ENDPOINT0_SIZE
 #define CFG_TUD_ENDPOINT0_SIZE    64
 #endif
@@ -120,13 +127,35 @@ extern "C" {
 
 #define CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX              2
 
-// 16bit data in 16bit slots
+// 24bit data in 24bit slots, the 1st streaming alternate setting (and the only one of UAC2)
 #define CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX      3
 #define CFG_TUD_AUDIO_FUNC_1_RESOLUTION_RX              24
 
-// UAC1 Full-Speed endpoint size
+// UAC1 Full-Speed endpoint size, the highest rate advertised in usb_descriptors.c
+// The OTG FS has only 320 words of FIFO RAM for the RX FIFO (2 packets of the largest EP) and all the IN EPs,
+// 88.2kHz (540B packets) fits only without the HID debug EP and 96kHz (582B) does not fit at all
+// The rates are the discrete list of the UAC1 format descriptor and the UAC2 clock source range,
+// all of them have to be in i2s_rate_table.h
+#if CFG_AUDIO_DEBUG
 #define CFG_TUD_AUDIO_FUNC_1_MAX_SAMPLE_RATE_FS     48000
-#define CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS           TUD_AUDIO_EP_SIZE(false, CFG_TUD_AUDIO_FUNC_1_MAX_SAMPLE_RATE_FS, CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX, CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX)
+#define AUDIO_SAMPLE_RATES                          44100, 48000
+#define AUDIO_SAMPLE_RATE_CNT                       2
+#else
+#define CFG_TUD_AUDIO_FUNC_1_MAX_SAMPLE_RATE_FS     88200
+#define AUDIO_SAMPLE_RATES                          44100, 48000, 88200
+#define AUDIO_SAMPLE_RATE_CNT                       3
+#endif
+// UAC1 has 2 more alternate settings: 16bit in 2 bytes (e.g. Android) and 24bit in 4 bytes (cheapest to unpack)
+// the 4 byte one is only up to 48kHz, at 88.2kHz its 720B packets would not fit into the FIFO RAM
+#define AUDIO_SAMPLE_RATES_32BIT                    44100, 48000
+#define AUDIO_SAMPLE_RATE_CNT_32BIT                 2
+#define AUDIO_MAX_SAMPLE_RATE_32BIT                 48000
+
+#define CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS_24BIT     TUD_AUDIO_EP_SIZE(false, CFG_TUD_AUDIO_FUNC_1_MAX_SAMPLE_RATE_FS, 3, CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX)
+#define CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS_16BIT     TUD_AUDIO_EP_SIZE(false, CFG_TUD_AUDIO_FUNC_1_MAX_SAMPLE_RATE_FS, 2, CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX)
+#define CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS_32BIT     TUD_AUDIO_EP_SIZE(false, AUDIO_MAX_SAMPLE_RATE_32BIT, 4, CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX)
+// the largest of the alternate settings, the RX FIFO and the SW buffer are sized for it
+#define CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS           TU_MAX(CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS_24BIT, TU_MAX(CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS_16BIT, CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS_32BIT))
 // UAC2 High-Speed endpoint size
 #define CFG_TUD_AUDIO_FUNC_1_MAX_SAMPLE_RATE_HS     96000
 #define CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_HS           TUD_AUDIO_EP_SIZE(true, CFG_TUD_AUDIO_FUNC_1_MAX_SAMPLE_RATE_HS, CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX, CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX)
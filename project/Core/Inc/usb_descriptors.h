@@ -30,6 +30,9 @@
 // UAC2 DESCRIPTOR TEMPLATES
 //--------------------------------------------------------------------+
 
+// UAC2 on the high speed port or on the full speed port when selected (CFG_AUDIO_UAC2)
+#define AUDIO_UAC2_ENABLED              (TUD_OPT_HIGH_SPEED || CFG_AUDIO_UAC2)
+
 // Defined in TUD_AUDIO20_SPEAKER_STEREO_FB_DESCRIPTOR
 #define UAC2_ENTITY_CLOCK               0x04
 #define UAC2_ENTITY_INPUT_TERMINAL      0x01
@@ -59,9 +62,9 @@
   /* Class-Specific AC Interface Header Descriptor(4.7.2) */\
   TUD_AUDIO20_DESC_CS_AC(/*_bcdADC*/ 0x0200, /*_category*/ AUDIO20_FUNC_DESKTOP_SPEAKER, /*_totallen*/ TUD_AUDIO20_DESC_CLK_SRC_LEN+TUD_AUDIO20_DESC_INPUT_TERM_LEN+TUD_AUDIO20_DESC_OUTPUT_TERM_LEN+TUD_AUDIO20_DESC_FEATURE_UNIT_LEN(2), /*_ctrl*/ AUDIO20_CS_AS_INTERFACE_CTRL_LATENCY_POS),\
   /* Clock Source Descriptor(4.7.2.1) */\
-  TUD_AUDIO20_DESC_CLK_SRC(/*_clkid*/ 0x04, /*_attr*/ AUDIO20_CLOCK_SOURCE_ATT_INT_PRO_CLK, /*_ctrl*/ (AUDIO20_CTRL_RW << AUDIO20_CLOCK_SOURCE_CTRL_CLK_FRQ_POS), /*_assocTerm*/ 0x01,  /*_stridx*/ 0x00),\
+  TUD_AUDIO20_DESC_CLK_SRC(/*_clkid*/ 0x04, /*_attr*/ AUDIO20_CLOCK_SOURCE_ATT_INT_PRO_CLK, /*_ctrl*/ (AUDIO20_CTRL_RW << AUDIO20_CLOCK_SOURCE_CTRL_CLK_FRQ_POS) | (AUDIO20_CTRL_R << AUDIO20_CLOCK_SOURCE_CTRL_CLK_VAL_POS), /*_assocTerm*/ 0x01,  /*_stridx*/ 0x00),\
   /* Input Terminal Descriptor(4.7.2.4) */\
-  TUD_AUDIO20_DESC_INPUT_TERM(/*_termid*/ 0x01, /*_termtype*/ AUDIO_TERM_TYPE_USB_STREAMING, /*_assocTerm*/ 0x00, /*_clkid*/ 0x04, /*_nchannelslogical*/ 0x02, /*_channelcfg*/ AUDIO20_CHANNEL_CONFIG_NON_PREDEFINED, /*_idxchannelnames*/ 0x00, /*_ctrl*/ 0 * (AUDIO20_CTRL_R << AUDIO20_IN_TERM_CTRL_CONNECTOR_POS), /*_stridx*/ 0x00),\
+  TUD_AUDIO20_DESC_INPUT_TERM(/*_termid*/ 0x01, /*_termtype*/ AUDIO_TERM_TYPE_USB_STREAMING, /*_assocTerm*/ 0x00, /*_clkid*/ 0x04, /*_nchannelslogical*/ 0x02, /*_channelcfg*/ AUDIO20_CHANNEL_CONFIG_FRONT_LEFT | AUDIO20_CHANNEL_CONFIG_FRONT_RIGHT, /*_idxchannelnames*/ 0x00, /*_ctrl*/ 0 * (AUDIO20_CTRL_R << AUDIO20_IN_TERM_CTRL_CONNECTOR_POS), /*_stridx*/ 0x00),\
   /* Output Terminal Descriptor(4.7.2.5) */\
   TUD_AUDIO20_DESC_OUTPUT_TERM(/*_termid*/ 0x03, /*_termtype*/ AUDIO_TERM_TYPE_OUT_DESKTOP_SPEAKER, /*_assocTerm*/ 0x01, /*_srcid*/ 0x02, /*_clkid*/ 0x04, /*_ctrl*/ 0x0000, /*_stridx*/ 0x00),\
   /* Feature Unit Descriptor(4.7.2.8) */\
@@ -73,7 +76,7 @@
   /* Interface 1, Alternate 1 - alternate interface for data streaming */\
   TUD_AUDIO20_DESC_STD_AS_INT(/*_itfnum*/ (uint8_t)((_itfnum) + 1), /*_altset*/ 0x01, /*_nEPs*/ 0x02, /*_stridx*/ 0x00),\
   /* Class-Specific AS Interface Descriptor(4.9.2) */\
-  TUD_AUDIO20_DESC_CS_AS_INT(/*_termid*/ 0x01, /*_ctrl*/ AUDIO20_CTRL_NONE, /*_formattype*/ AUDIO20_FORMAT_TYPE_I, /*_formats*/ AUDIO20_DATA_FORMAT_TYPE_I_PCM, /*_nchannelsphysical*/ 0x02, /*_channelcfg*/ AUDIO20_CHANNEL_CONFIG_NON_PREDEFINED, /*_stridx*/ 0x00),\
+  TUD_AUDIO20_DESC_CS_AS_INT(/*_termid*/ 0x01, /*_ctrl*/ AUDIO20_CTRL_NONE, /*_formattype*/ AUDIO20_FORMAT_TYPE_I, /*_formats*/ AUDIO20_DATA_FORMAT_TYPE_I_PCM, /*_nchannelsphysical*/ 0x02, /*_channelcfg*/ AUDIO20_CHANNEL_CONFIG_FRONT_LEFT | AUDIO20_CHANNEL_CONFIG_FRONT_RIGHT, /*_stridx*/ 0x00),\
   /* Type I Format Type Descriptor(2.3.1.6 - Audio Formats) */\
   TUD_AUDIO20_DESC_TYPE_I_FORMAT(_nBytesPerSample, _nBitsUsedPerSample),\
   /* Standard AS Isochronous Audio Data Endpoint Descriptor(4.10.1.1) */\
@@ -92,21 +95,21 @@
 #define UAC1_ENTITY_FEATURE_UNIT        0x02
 #define UAC1_ENTITY_OUTPUT_TERMINAL     0x03
 
-#define TUD_AUDIO10_SPEAKER_STEREO_FB_DESC_LEN(_nfreqs) (\
+// Streaming alternate settings, the sample format of each (see tud_audio_set_itf_cb())
+#define UAC1_ALT_24BIT                  0x01
+#define UAC1_ALT_16BIT                  0x02
+#define UAC1_ALT_32BIT                  0x03
+
+// the control interface and the zero bandwidth alternate setting, followed by TUD_AUDIO10_SPEAKER_STREAM_ALT_DESCRIPTOR()s
+#define TUD_AUDIO10_SPEAKER_STEREO_FB_DESC_LEN (\
   + TUD_AUDIO10_DESC_STD_AC_LEN\
   + TUD_AUDIO10_DESC_CS_AC_LEN(1)\
   + TUD_AUDIO10_DESC_INPUT_TERM_LEN\
   + TUD_AUDIO10_DESC_OUTPUT_TERM_LEN\
-  + TUD_AUDIO10_DESC_FEATURE_UNIT_LEN(0)\
-  + TUD_AUDIO10_DESC_STD_AS_LEN\
-  + TUD_AUDIO10_DESC_STD_AS_LEN\
-  + TUD_AUDIO10_DESC_CS_AS_INT_LEN\
-  + TUD_AUDIO10_DESC_TYPE_I_FORMAT_LEN(_nfreqs)\
-  + TUD_AUDIO10_DESC_STD_AS_ISO_EP_LEN\
-  + TUD_AUDIO10_DESC_CS_AS_ISO_EP_LEN\
-  + TUD_AUDIO10_DESC_STD_AS_ISO_SYNC_EP_LEN)
+  + TUD_AUDIO10_DESC_FEATURE_UNIT_LEN(2)\
+  + TUD_AUDIO10_DESC_STD_AS_LEN)
 
-#define TUD_AUDIO10_SPEAKER_STEREO_FB_DESCRIPTOR(_itfnum, _stridx, _nBytesPerSample, _nBitsUsedPerSample, _epout, _epoutsize, _epfb, ...) \
+#define TUD_AUDIO10_SPEAKER_STEREO_FB_DESCRIPTOR(_itfnum, _stridx) \
   /* Standard AC Interface Descriptor(4.3.1) */\
   TUD_AUDIO10_DESC_STD_AC(/*_itfnum*/ _itfnum, /*_nEPs*/ 0x00, /*_stridx*/ _stridx),\
   /* Class-Specific AC Interface Header Descriptor(4.3.2) */\
@@ -116,13 +119,24 @@
   /* Output Terminal Descriptor(4.3.2.2) */\
   TUD_AUDIO10_DESC_OUTPUT_TERM(/*_termid*/ 0x03, /*_termtype*/ AUDIO_TERM_TYPE_OUT_DESKTOP_SPEAKER, /*_assocTerm*/ 0x00, /*_srcid*/ 0x02, /*_stridx*/ 0x00),\
   /* Feature Unit Descriptor(4.3.2.5) */\
-  TUD_AUDIO10_DESC_FEATURE_UNIT(/*_unitid*/ 0x02, /*_srcid*/ 0x01, /*_stridx*/ 0x00, /*_ctrlmaster*/ (AUDIO10_FU_CONTROL_BM_MUTE | AUDIO10_FU_CONTROL_BM_VOLUME)),\
+  TUD_AUDIO10_DESC_FEATURE_UNIT(/*_unitid*/ 0x02, /*_srcid*/ 0x01, /*_stridx*/ 0x00, /*_ctrlmaster*/ (AUDIO10_FU_CONTROL_BM_MUTE | AUDIO10_FU_CONTROL_BM_VOLUME), /*_ctrlch1*/ (AUDIO10_FU_CONTROL_BM_MUTE | AUDIO10_FU_CONTROL_BM_VOLUME), /*_ctrlch2*/ (AUDIO10_FU_CONTROL_BM_MUTE | AUDIO10_FU_CONTROL_BM_VOLUME)),\
   /* Standard AS Interface Descriptor(4.5.1) */\
   /* Interface 1, Alternate 0 - default alternate setting with 0 bandwidth */\
-  TUD_AUDIO10_DESC_STD_AS_INT(/*_itfnum*/ (uint8_t)((_itfnum)+1), /*_altset*/ 0x00, /*_nEPs*/ 0x00, /*_stridx*/ 0x00),\
+  TUD_AUDIO10_DESC_STD_AS_INT(/*_itfnum*/ (uint8_t)((_itfnum)+1), /*_altset*/ 0x00, /*_nEPs*/ 0x00, /*_stridx*/ 0x00)
+
+#define TUD_AUDIO10_SPEAKER_STREAM_ALT_DESC_LEN(_nfreqs) (\
+  + TUD_AUDIO10_DESC_STD_AS_LEN\
+  + TUD_AUDIO10_DESC_CS_AS_INT_LEN\
+  + TUD_AUDIO10_DESC_TYPE_I_FORMAT_LEN(_nfreqs)\
+  + TUD_AUDIO10_DESC_STD_AS_ISO_EP_LEN\
+  + TUD_AUDIO10_DESC_CS_AS_ISO_EP_LEN\
+  + TUD_AUDIO10_DESC_STD_AS_ISO_SYNC_EP_LEN)
+
+// '_itfnum' is the control interface, the same as for TUD_AUDIO10_SPEAKER_STEREO_FB_DESCRIPTOR()
+#define TUD_AUDIO10_SPEAKER_STREAM_ALT_DESCRIPTOR(_itfnum, _altset, _nBytesPerSample, _nBitsUsedPerSample, _epout, _epoutsize, _epfb, ...) \
   /* Standard AS Interface Descriptor(4.5.1) */\
-  /* Interface 1, Alternate 1 - alternate interface for data streaming */\
-  TUD_AUDIO10_DESC_STD_AS_INT(/*_itfnum*/ (uint8_t)((_itfnum)+1), /*_altset*/ 0x01, /*_nEPs*/ 0x02, /*_stridx*/ 0x00),\
+  /* Interface 1, Alternate N - alternate interface for data streaming */\
+  TUD_AUDIO10_DESC_STD_AS_INT(/*_itfnum*/ (uint8_t)((_itfnum)+1), /*_altset*/ _altset, /*_nEPs*/ 0x02, /*_stridx*/ 0x00),\
   /* Class-Specific AS Interface Descriptor(4.5.2) */\
   TUD_AUDIO10_DESC_CS_AS_INT(/*_termid*/ 0x01, /*_delay*/ 0x00, /*_formattype*/ AUDIO10_DATA_FORMAT_TYPE_I_PCM),\
   /* Type I Format Type Descriptor(2.2.5) */\
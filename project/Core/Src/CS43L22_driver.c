@@ -27,10 +27,17 @@ SOFTWARE.
 
 #include "CS43L22_driver.h"
 #include "custom_math.h"
+#include "audio_unpack.h"
+#include "audio_fifo.h"
+#include "audio_asrc.h"
+#include "audio_pipeline.h"
+#include "i2s_rate_table.h"
 #include "stm32f4xx_hal.h"
 #include "main.h"
 #include "tusb.h"
 #include <stdio.h>
+#include <math.h>
+#include <string.h>
 
 #define CODEC_I2C_ADDR 0x94
 
@@ -90,26 +97,100 @@ static I2S_HandleTypeDef *hi2s;
 #define   CS43L22_REG_CHARGE_PUMP_FREQ    0x34
 
 
-static uint8_t i2s_stream_state = I2S_AUDIO_STOPPED;
+// written from the main loop (play/stop) and from the DMA ISR (end of the fade out)
+static volatile uint8_t i2s_stream_state = I2S_AUDIO_STOPPED;
 
-typedef enum {
-	SEND_2ND_HALF_FILL_1ST = 1,
-	SEND_1ST_HALF_FILL_2ND = 2
-} BuffStatus;
-BuffStatus buffStatus = SEND_1ST_HALF_FILL_2ND;
+// the buffers are sized for the highest rate the USB descriptor advertises,
+// the lengths below are set for the current rate by set_lengths()
+#define MAX_SAMPLING_RATE       CFG_TUD_AUDIO_FUNC_1_MAX_SAMPLE_RATE_FS
+#define MAX_FRAMES(us)          ((MAX_SAMPLING_RATE * (us) + 999999) / 1000000)
 
+static uint32_t sample_rate = AUDIO_SAMPLING_RATE;
 
-// data comes each 1ms -> at 48KHz it will be 48 samples per channel
-#define SAMP_PER_CHANNEL        48
-#define SAMP_ALL_CHANNELS       2 * SAMP_PER_CHANNEL // we have 2 channels
-#define TOTAL_AUDIO_SAMPLES     2 * SAMP_ALL_CHANNELS // we have circular double buffering
-#define BUFFER_BYTE_LEN	        4 * TOTAL_AUDIO_SAMPLES // 32bit frame
+// USB subslot size of the selected alternate setting and its unpack kernel
+static uint8_t sample_bytes = CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX;
+static AudioUnpackFunc unpack = unpack_24_to_i2s;
+
+// raised cosine fade in/out on stream start/stop, applied in the refill
+// so start/stop is click free without any I2C traffic (PCM mute)
+#define RAMP_MS                 5
+#define RAMP_FRAMES_MAX         MAX_FRAMES(RAMP_MS * 1000)
+
+// gain in Q15, the last step is the unity gain which is not stored (no multiplication needed)
+static uint16_t ramp_table[RAMP_FRAMES_MAX];
+static uint16_t ramp_frames;
+// current position in the ramp, ramp_frames is fully faded in, 0 is silence
+static uint16_t ramp_pos = 0;
+
+static void ramp_init(void) {
+	ramp_frames = sample_rate * RAMP_MS / 1000;
+	for (uint16_t i = 0; i < ramp_frames; ++i) {
+		const float gain = 0.5f * (1.0f - cosf((float)M_PI * i / ramp_frames));
+		ramp_table[i] = (uint16_t)(gain * 32767.0f);
+	}
+}
+
+
+// data comes each 1ms -> at 48KHz it will be 48 samples per channel in a 1ms period
+// at 44.1kHz the period is 44 frames (0.998ms), the USB packets are 44 and 45 frames,
+// the difference is taken up by the FIFO (feedback) the same way as any clock drift
+#define SAMP_PER_CHANNEL_MAX    MAX_FRAMES(AUDIO_PERIOD_US)
+#define TOTAL_AUDIO_SAMPLES_MAX (AUDIO_PERIOD_CNT * 2 * SAMP_PER_CHANNEL_MAX)
+#define BUFFER_BYTE_LEN         (4 * TOTAL_AUDIO_SAMPLES_MAX) // 32bit frame
+
+static uint16_t samp_per_channel;
+static uint16_t samp_all_channels;      // we have 2 channels
+static uint16_t total_audio_samples;    // circular buffer of N periods
+static uint16_t period_byte_len;        // 32bit frame
+
+_Static_assert(AUDIO_PERIOD_CNT >= 2, "at least a double buffer is needed");
+_Static_assert(TOTAL_AUDIO_SAMPLES_MAX * 2 <= 0xFFFF, "DMA can transfer max 65535 items");
+
+// next period to be refilled, the DMA is always "in front" of it
+static uint8_t fill_period = 0;
+
+// statistics of the period scheduler, to see how much jitter the refill has
+I2sPeriodStats i2s_period_stats;
+
+AudioStreamStats audio_stream_stats;
+
+// when the USB FIFO runs dry the last frame is repeated and faded out to zero in 1ms
+static uint16_t conceal_frames;
+
+static int32_t last_frame[2]; // last good L and R sample
+static uint16_t conceal_pos = UINT16_MAX; // position in the fade, start faded out
+
+// the fade out does not read the FIFO, see audio_stop_concealed()
+static volatile bool stop_concealed;
+
+#if CFG_AUDIO_ASRC
+// input of the ASRC, Q31 stereo frames taken from the USB FIFO but not consumed yet
+// it has to hold the frames of one period at the max ratio + the interpolation points
+#define ASRC_IN_FRAMES          (SAMP_PER_CHANNEL_MAX + 8)
+
+static AudioAsrc asrc;
+static int32_t asrc_in[2 * ASRC_IN_FRAMES];
+static uint16_t asrc_in_frames = 0;
+#endif
 
 // this is the actual DMA buffer
-uint8_t i2s_audio_buffer[BUFFER_BYTE_LEN];
+// word aligned, so the unpack kernel can write whole 32bit frames
+uint8_t i2s_audio_buffer[BUFFER_BYTE_LEN] __attribute__((aligned(4)));
 
 static uint8_t isFirst = 1;
 
+// the DMA position at the last audio_get_played_frames()
+static uint32_t last_pos = 0;
+
+static void set_lengths(void) {
+	// rounded down to whole frames when the rate is not a multiple of the period (44.1kHz, see above)
+	samp_per_channel = sample_rate * AUDIO_PERIOD_US / 1000000;
+	samp_all_channels = 2 * samp_per_channel;
+	total_audio_samples = AUDIO_PERIOD_CNT * samp_all_channels;
+	period_byte_len = 4 * samp_all_channels;
+	conceal_frames = sample_rate / 1000;
+}
+
 //-------------------------------------------------------------------------------------------------------
 //---------------------------- low level I2C access -----------------------------------------------------
 //-------------------------------------------------------------------------------------------------------
@@ -120,15 +201,26 @@ HAL_StatusTypeDef codec_i2c_write_reg(uint8_t addr, uint8_t val) {
 			(uint8_t[]) { addr, val }, 2, 1000);
 }
 
-// this is blocking for even more
-HAL_StatusTypeDef codec_i2c_read_reg(uint8_t addr, uint8_t *val) {
+// consecutive registers in one transfer, the MAP auto increment bit (7.3 Memory Address Pointer)
+HAL_StatusTypeDef codec_i2c_write_regs(uint8_t addr, const uint8_t *val, uint8_t n) {
+	uint8_t buf[1 + 4];
+	if (n > sizeof(buf) - 1) {
+		return HAL_ERROR;
+	}
+	buf[0] = addr | 0x80;
+	memcpy(&buf[1], val, n);
+	return HAL_I2C_Master_Transmit(hi2c, CODEC_I2C_ADDR, buf, 1 + n, 1000);
+}
+
+// this is blocking for even more, up to 'timeout_ms' for each of the 2 transfers
+HAL_StatusTypeDef codec_i2c_read_reg(uint8_t addr, uint8_t *val, uint32_t timeout_ms) {
 	HAL_StatusTypeDef result = HAL_I2C_Master_Transmit(hi2c, CODEC_I2C_ADDR,
-			(uint8_t[] ) { addr }, 1, 1000);
+			(uint8_t[] ) { addr }, 1, timeout_ms);
 	if (result != HAL_OK) {
 		return 1;
 	}
 
-	return HAL_I2C_Master_Receive(hi2c, CODEC_I2C_ADDR, val, 1, 1000);
+	return HAL_I2C_Master_Receive(hi2c, CODEC_I2C_ADDR, val, 1, timeout_ms);
 }
 
 
@@ -162,6 +254,9 @@ int CS43L22_init(void *i2c, void *i2s) {
 	// register settings are loaded, re-apply power
 	success += codec_i2c_write_reg(CS43L22_REG_POWER_CTL1, 0x9E);
 
+	set_lengths();
+	ramp_init();
+
 	// if there was any error it will be non zero
 	return success != 0;
 }
@@ -186,8 +281,8 @@ int CS43L22_set_hp_volume_db(int16_t vol_L, int16_t vol_R) {
   printf("CS43L22_hp L: 0x%X R: 0x%X\n", vol_L, vol_R);
 
   // CS43L22 has a 0.5db resolution
-  success += codec_i2c_write_reg(CS43L22_REG_HEADPHONE_A_VOL, vol_L);
-  success += codec_i2c_write_reg(CS43L22_REG_HEADPHONE_B_VOL, vol_R);
+  // A and B are next to each other, so both go in one transfer (a balance change is one update)
+  success += codec_i2c_write_regs(CS43L22_REG_HEADPHONE_A_VOL, (uint8_t[]) { vol_L, vol_R }, 2);
 
   // if there was any error it will be non zero
   return success != 0;
@@ -203,8 +298,9 @@ int CS43L22_set_hp_analog_gain(uint8_t gain_id) {
 	  return success != 0;
 }
 
-int CS43L22_set_hp_mute(int8_t mute) {
-	  uint8_t value = mute > 0 ? 0b11000000 : 0b00000000;
+int CS43L22_set_hp_mute(int8_t mute_L, int8_t mute_R) {
+	  // HPBMUTE (R) | HPAMUTE (L)
+	  uint8_t value = (mute_R > 0 ? 0b10000000 : 0) | (mute_L > 0 ? 0b01000000 : 0);
 	  uint8_t success = 0;
 	  success += codec_i2c_write_reg(CS43L22_REG_PLAYBACK_CTL2, value);
 
@@ -231,10 +327,10 @@ int CS43L22_set_bass_treb_freq(uint8_t bass_id, uint8_t treb_id) {
 	return success != 0;
 }
 
-int CS43L22_read_clip_reg(uint8_t *result) {
+int CS43L22_read_clip_reg(uint8_t *result, uint32_t timeout_ms) {
 	uint8_t success = 0;
 	uint8_t value = 0;
-	success += codec_i2c_read_reg(CS43L22_REG_OVF_CLK_STATUS, &value);
+	success += codec_i2c_read_reg(CS43L22_REG_OVF_CLK_STATUS, &value, timeout_ms);
 
 	// test all the overflow flags in one
 	*result = (value & 0b00111100) ? 1 : 0;
@@ -276,23 +372,40 @@ int CS43L22_set_master_volume_db(int16_t vol_LR) {
 //----------------- only for used internally in CS43L22_driver -------
 //--------------------------------------------------------------------
 
-// do not use master mute as it has also the analog gain in the same register
-// will be hard to do write only
-int audio_set_pcm_mute(uint8_t mute) {
-	  uint8_t value = mute > 0 ? 0b10000000 : 0b00000000;
-	  uint8_t success = 0;
-	  success += codec_i2c_write_reg(CS43L22_REG_PCMA_VOL, value);
-	  success += codec_i2c_write_reg(CS43L22_REG_PCMB_VOL, value);
-
-	  // if there was any error it will be non zero
-	  return success != 0;
-}
-
 //-------------------------------------------------------------------------------------------------------
 //---------------------------- high level control -----------------------------------------------------
 //-------------------------------------------------------------------------------------------------------
 
 void audio_play() {
+	// the fade out is still running: turn it around, the refill ramps back up from the current ramp_pos
+	// (the FIFO was read during the fade, so the stream just goes on)
+	// the refill may end the fade meanwhile, so the check and the change are done without it
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	// (not a fade out for a format switch, the FIFO has the new format already)
+	const bool resumed = (i2s_stream_state == I2S_AUDIO_STOPPING) && !stop_concealed;
+	if (resumed) {
+		i2s_stream_state = I2S_AUDIO_STREAMING;
+	}
+	__set_PRIMASK(primask);
+
+	if (resumed) {
+		HAL_GPIO_WritePin(LED_Orange_GPIO_Port, LED_Orange_Pin, GPIO_PIN_SET);
+		return;
+	}
+	if (i2s_stream_state != I2S_AUDIO_STOPPED) {
+		return;
+	}
+
+	// start from silence, the refill does the fade in
+	// nothing of the last stream may be left in the stages (the limiter delay line, the filter states)
+	audio_pipeline_reset();
+	ramp_pos = 0;
+	stop_concealed = false;
+#if CFG_AUDIO_ASRC
+	audio_asrc_init(&asrc, sample_rate / 1000 * 4);
+	asrc_in_frames = 0;
+#endif
 	i2s_stream_state = I2S_AUDIO_STREAMING;
 	HAL_GPIO_WritePin(LED_Orange_GPIO_Port, LED_Orange_Pin, GPIO_PIN_SET);
 
@@ -300,16 +413,19 @@ void audio_play() {
 		isFirst = 0;
 		// the I2S is set to 32bit frame and the Size is the 32Bit size in this case !
 		// no need to mul by 2 because of 24bit in 32b frame on a 16bit pointer ...
-		HAL_I2S_Transmit_DMA(hi2s, (uint16_t*)i2s_audio_buffer, TOTAL_AUDIO_SAMPLES);
+		HAL_I2S_Transmit_DMA(hi2s, (uint16_t*)i2s_audio_buffer, total_audio_samples);
 	}
-	audio_set_pcm_mute(0);
 }
 
 void audio_stop() {
-	i2s_stream_state = I2S_AUDIO_STOPPED;
-	HAL_GPIO_WritePin(LED_Orange_GPIO_Port , LED_Orange_Pin, GPIO_PIN_RESET);
+	if (i2s_stream_state != I2S_AUDIO_STREAMING) {
+		return;
+	}
 
-	audio_set_pcm_mute(1);
+	// the refill fades out from the current ramp position, and when it reaches silence
+	// it sets the I2S_AUDIO_STOPPED state and keeps the DMA buffer zeroed
+	i2s_stream_state = I2S_AUDIO_STOPPING;
+	HAL_GPIO_WritePin(LED_Orange_GPIO_Port , LED_Orange_Pin, GPIO_PIN_RESET);
 
 	// 1. Mute the DAC's and PWM outputs
 	// 2. Disable soft ramp and zero cross volume transitions.
@@ -322,66 +438,362 @@ void audio_stop() {
 	// check 4.10 Recommended Power-Down Sequence of the CS43L22 data sheet
 	// for now it states that a fully powered peripheral consumes 25mW
 	// HAL_I2S_DMAStop(hi2s);
+}
 
-	 memset(i2s_audio_buffer, 0, BUFFER_BYTE_LEN);
+void audio_stop_concealed(void) {
+	stop_concealed = true;
+	audio_stop();
 }
 
 inline I2sAudioState get_audio_state() {
 	return i2s_stream_state;
 }
 
+static const I2sRateConfig* find_rate(uint32_t rate) {
+	if (rate > MAX_SAMPLING_RATE) {
+		return NULL;
+	}
+	for (uint8_t i = 0; i < I2S_RATE_TABLE_LEN; ++i) {
+		if (i2s_rate_table[i].sample_rate == rate) {
+			return &i2s_rate_table[i];
+		}
+	}
+	return NULL;
+}
+
+bool audio_is_sample_rate_supported(uint32_t rate) {
+	return find_rate(rate) != NULL;
+}
+
+uint32_t audio_get_sample_rate(void) {
+	return sample_rate;
+}
+
+// back to the clocks from before a failed rate change, as they were
+static void restore_clocks(uint32_t pllcfg, uint32_t audio_freq, uint32_t i2spr) {
+	__HAL_RCC_PLLI2S_DISABLE();
+	uint32_t start = HAL_GetTick();
+	while ((__HAL_RCC_GET_FLAG(RCC_FLAG_PLLI2SRDY) != RESET) && (HAL_GetTick() - start < PLLI2S_TIMEOUT_VALUE)) {}
+	RCC->PLLI2SCFGR = pllcfg;
+	__HAL_RCC_PLLI2S_ENABLE();
+	start = HAL_GetTick();
+	while ((__HAL_RCC_GET_FLAG(RCC_FLAG_PLLI2SRDY) == RESET) && (HAL_GetTick() - start < PLLI2S_TIMEOUT_VALUE)) {}
+
+	hi2s->Init.AudioFreq = audio_freq;
+	if (HAL_I2S_Init(hi2s) != HAL_OK) {
+		printf("audio: I2S restore failed\n");
+	}
+	hi2s->Instance->I2SPR = i2spr;
+}
+
+bool audio_set_sample_rate(uint32_t rate) {
+	const I2sRateConfig *cfg = find_rate(rate);
+	if (cfg == NULL) {
+		printf("audio: %luHz is not supported\n", rate);
+		return false;
+	}
+	// the ring and the tables change, the refill must not run meanwhile
+	if (i2s_stream_state != I2S_AUDIO_STOPPED) {
+		return false;
+	}
+	if (rate == sample_rate) {
+		return true;
+	}
+
+	// the DMA is restarted on the next play with the new ring length
+	if (!isFirst) {
+		HAL_I2S_DMAStop(hi2s);
+		isFirst = 1;
+	}
+
+	// the clocks as they are now, restored on a failure
+	const uint32_t old_pllcfg = RCC->PLLI2SCFGR;
+	const uint32_t old_freq = hi2s->Init.AudioFreq;
+	const uint32_t old_i2spr = hi2s->Instance->I2SPR;
+
+	// the codec is powered down while the clocks change (4.10 Recommended Power-Down Sequence)
+	codec_i2c_write_reg(CS43L22_REG_POWER_CTL1, 0x9F);
+
+	bool ok = true;
+	RCC_PeriphCLKInitTypeDef clk = {0};
+	clk.PeriphClockSelection = RCC_PERIPHCLK_I2S;
+	clk.PLLI2S.PLLI2SM = cfg->plli2s_m;
+	clk.PLLI2S.PLLI2SN = cfg->plli2s_n;
+	clk.PLLI2S.PLLI2SR = cfg->plli2s_r;
+	if (HAL_RCCEx_PeriphCLKConfig(&clk) != HAL_OK) {
+		printf("audio: PLLI2S config failed\n");
+		ok = false;
+	}
+
+	if (ok) {
+		hi2s->Init.AudioFreq = rate;
+		if (HAL_I2S_Init(hi2s) != HAL_OK) {
+			printf("audio: I2S init failed\n");
+			ok = false;
+		}
+	}
+
+	if (ok) {
+		// the HAL rounds the divider for the nominal PLLI2S, the table has the exact one
+		MODIFY_REG(hi2s->Instance->I2SPR, SPI_I2SPR_I2SDIV | SPI_I2SPR_ODD,
+				cfg->i2s_div | ((uint32_t)cfg->i2s_odd << SPI_I2SPR_ODD_Pos));
+		sample_rate = rate;
+	} else {
+		// the old rate stays, the codec must not be left powered down
+		restore_clocks(old_pllcfg, old_freq, old_i2spr);
+	}
+
+	codec_i2c_write_reg(CS43L22_REG_POWER_CTL1, 0x9E);
+
+	set_lengths();
+	ramp_init();
+	memset(i2s_audio_buffer, 0, sizeof(i2s_audio_buffer));
+	fill_period = 0;
+	last_pos = 0;
+	conceal_pos = conceal_frames;
+
+	if (ok) {
+		printf("audio: %luHz (%+dppm)\n", rate, cfg->ppm_x10 / 10);
+	} else {
+		printf("audio: stays at %luHz\n", sample_rate);
+	}
+	return ok;
+}
+
+uint8_t audio_get_sample_bytes(void) {
+	return sample_bytes;
+}
+
+bool audio_set_sample_bytes(uint8_t bytes) {
+	const AudioUnpackFunc kernel = unpack_get_kernel(bytes);
+	if (kernel == NULL) {
+		printf("audio: %u byte samples are not supported\n", bytes);
+		return false;
+	}
+	// the refill must not run with a half switched format
+	if (i2s_stream_state != I2S_AUDIO_STOPPED) {
+		return false;
+	}
+
+	sample_bytes = bytes;
+	unpack = kernel;
+	printf("audio: %u byte samples\n", bytes);
+	return true;
+}
+
 //-------------------------------------------------------------------------------------------------------
 //---------------------------- I2S DMA callbacks -----------------------------------------------------
 //-------------------------------------------------------------------------------------------------------
 
-void loadMore() {
+// see audio_fifo_read_to_i2s()
+static inline uint16_t read_fifo_to_i2s(uint8_t *dst, uint16_t n_samples) {
+    return audio_fifo_read_to_i2s(tud_audio_get_ep_out_ff(), dst, n_samples, sample_bytes, unpack);
+}
+
+#if CFG_AUDIO_ASRC
+// Same as read_fifo_to_i2s(), but through the ASRC. The FIFO is read into the ASRC input buffer,
+// which keeps the not consumed frames (and the interpolation history) for the next period.
+// returns the number of samples actually produced
+static uint16_t read_fifo_asrc(uint32_t *dst, uint16_t n_samples) {
+    const uint16_t fifo_frames = tu_fifo_count(tud_audio_get_ep_out_ff()) / (2 * sample_bytes);
+    audio_asrc_update(&asrc, fifo_frames + asrc_in_frames);
+
+    const uint16_t need = MIN(audio_asrc_needed(&asrc, n_samples / 2), ASRC_IN_FRAMES);
+    if (need > asrc_in_frames) {
+        // unpacked as I2S frames in place, then converted to Q31
+        uint32_t *raw = (uint32_t*)&asrc_in[2 * asrc_in_frames];
+        const uint16_t got = read_fifo_to_i2s((uint8_t*)raw, 2 * (need - asrc_in_frames));
+        for (uint16_t i = 0; i < got; ++i) {
+            raw[i] = (uint32_t)i2s_frame_to_q31(raw[i]);
+        }
+        asrc_in_frames += got / 2;
+    }
+
+    uint16_t consumed;
+    const uint16_t produced = audio_asrc_process(&asrc, asrc_in, asrc_in_frames,
+            (int32_t*)dst, n_samples / 2, &consumed);
+
+    asrc_in_frames -= consumed;
+    memmove(asrc_in, &asrc_in[2 * consumed], asrc_in_frames * 2 * sizeof(int32_t));
+
+    for (uint16_t i = 0; i < 2 * produced; ++i) {
+        dst[i] = q31_to_i2s_frame((int32_t)dst[i]);
+    }
+    return 2 * produced;
+}
+#endif
+
+// fill the rest of the period with the last good frame faded out to zero (hold-then-ramp)
+// this way a short read is a short fade and not the stale data from N periods earlier
+static void conceal(uint32_t *dst, uint16_t n_samples) {
+    for (uint16_t i = 0; i < n_samples; i += 2) {
+        const int32_t gain = conceal_frames - MIN(conceal_pos, conceal_frames);
+
+        // 24bit sample x max 8bit gain fits well into 32bit
+        dst[i + 0] = q31_to_i2s_frame(((last_frame[0] >> 8) * gain / conceal_frames) << 8);
+        dst[i + 1] = q31_to_i2s_frame(((last_frame[1] >> 8) * gain / conceal_frames) << 8);
+
+        if (conceal_pos < conceal_frames) {
+            ++conceal_pos;
+        }
+    }
+}
+
+// applies the start (fade in) or stop (fade out) ramp on the frames
+// returns the number of samples which are still audible, after a finished fade out it is all zero
+static uint16_t apply_ramp(uint32_t *dst, uint16_t n_samples) {
+    const bool fade_out = (i2s_stream_state == I2S_AUDIO_STOPPING);
+
+    for (uint16_t i = 0; i < n_samples; i += 2) {
+        if (fade_out) {
+            if (ramp_pos == 0) {
+                return i;
+            }
+            --ramp_pos;
+        } else if (ramp_pos >= ramp_frames) {
+            // fully faded in, the rest is unity gain
+            break;
+        }
+
+        const int32_t gain = ramp_table[ramp_pos];
+        dst[i + 0] = q31_to_i2s_frame((int32_t)(((int64_t)i2s_frame_to_q31(dst[i + 0]) * gain) >> 15));
+        dst[i + 1] = q31_to_i2s_frame((int32_t)(((int64_t)i2s_frame_to_q31(dst[i + 1]) * gain) >> 15));
+
+        if (!fade_out) {
+            ++ramp_pos;
+        }
+    }
+
+    return n_samples;
+}
+
+// refills one period of the DMA buffer
+static void loadMore(uint8_t period) {
     // add new stuff when available
-    const uint16_t I2S_BUFF_OFFS = buffStatus == SEND_2ND_HALF_FILL_1ST ? 0 : BUFFER_BYTE_LEN/2;
-    static uint8_t samples_lr_24[SAMP_ALL_CHANNELS * 3]; // buffer for tud_audio_read() for 24bit data
+    const uint16_t I2S_BUFF_OFFS = period * period_byte_len;
+    uint32_t *dst = (uint32_t*)&i2s_audio_buffer[I2S_BUFF_OFFS];
 
     // since we are not stopping the I2S it will deplete the USB FIFO fully
     // but additionally it will also slow the refill significantly
     // so take samples out of the USB FIFO only when really playing
     if (i2s_stream_state == I2S_AUDIO_STOPPED) {
+        memset(dst, 0, period_byte_len);
     	return;
     }
 
-    // tud_audio_read() reads in bytes
-    // reading 24bit
+    // reading 16bit, 24bit or 24-in-32bit, whatever alternate setting the host selected (see audio_set_sample_bytes())
     // read all the samples from USB in one block as reading it one by one is fairly expensive
     // measured the whole loadMore() by DWT counter.
     //   - using tud_audio_read() one by one (inside a loop) is ~44500 clocks
     //   - using tud_audio_read() as one big block ~8400 clocks
     // does not really matter if Debug or Release build was used
-    tud_audio_read(samples_lr_24, SAMP_ALL_CHANNELS * 3);
-
-   // expand 24bit data to 32bit frame
-    for (int i=0; i<SAMP_ALL_CHANNELS; ++i) {
-    	// This might be confusing, but it is needed as we pass virtually 2x16bits onto the DAC.
-    	// Each 16bit has a buff[1]-> MSB and buff[0]-> LSB because endian-ness
-    	// can be better seen in an union.
-    	// But the 2x 16Bit buffer is the opposite because how the I2S works:
-    	// more sensitive 16bit first, less sensitive 16bit last
-    	// so the mapping is
-    	//   USB   array:  0, 1, 2 -> LSB, MID, MSB
-    	//   I2S   array:  MSB[ LSB,  MSB  ] + LSB[ LSB, MSB  ]
-    	//   e.g.          MSB[ USB1, USB2 ] + LSB[   0, USB0 ]
-
-    	 i2s_audio_buffer[I2S_BUFF_OFFS + i*4+1] = samples_lr_24[i*3 + 2];
-    	 i2s_audio_buffer[I2S_BUFF_OFFS + i*4+0] = samples_lr_24[i*3 + 1];
-
-    	 i2s_audio_buffer[I2S_BUFF_OFFS + i*4+3] = samples_lr_24[i*3 + 0];
-      // i2s_audio_buffer[I2S_BUFF_OFFS + i*4+2] = 0;
+    // Now the samples are unpacked directly from the FIFO memory into the DMA buffer,
+    // there is no intermediate copy (and staging buffer) anymore
+    // and the unpack itself is done word wide, see unpack_benchmark() for the numbers of all 3 kernels
+    // a format switch is pending, the old kernel must not read the new format: the fade out is concealed
+    const bool fifo_held = stop_concealed && (i2s_stream_state == I2S_AUDIO_STOPPING);
+#if CFG_AUDIO_ASRC
+    const uint16_t n = fifo_held ? 0 : read_fifo_asrc(dst, samp_all_channels);
+#else
+    const uint16_t n = fifo_held ? 0 : read_fifo_to_i2s((uint8_t*)dst, samp_all_channels);
+#endif
+
+    if (n > 0) {
+        last_frame[0] = i2s_frame_to_q31(dst[n - 2]);
+        last_frame[1] = i2s_frame_to_q31(dst[n - 1]);
+        conceal_pos = 0;
+    }
+
+    if (n < samp_all_channels) {
+        if (!fifo_held) {
+            ++audio_stream_stats.short_reads;
+            audio_stream_stats.concealed_samples += samp_all_channels - n;
+        }
+        conceal(&dst[n], samp_all_channels - n);
+    }
+
+    // the DSP stages (EQ, ...), see audio_pipeline_print_stats() for their cost
+    if (audio_pipeline_active()) {
+        audio_pipeline_process(dst, samp_per_channel);
+    }
+
+    // ramp only when needed, in steady state it is a single compare
+    if ((i2s_stream_state == I2S_AUDIO_STOPPING) || (ramp_pos < ramp_frames)) {
+        const uint16_t audible = apply_ramp(dst, samp_all_channels);
+        if (audible < samp_all_channels) {
+            // the fade out is done, from now on only silence
+            memset(&dst[audible], 0, (samp_all_channels - audible) * 4);
+            i2s_stream_state = I2S_AUDIO_STOPPED;
+        }
+    }
+}
+
+// where the DMA is in the ring, in samples (32bit frames)
+static inline uint32_t dma_sample_pos(void) {
+    // the DMA counts down the remaining half words, 2 of them per 32bit frame
+    const uint32_t remaining = __HAL_DMA_GET_COUNTER(hi2s->hdmatx);
+    return (2 * total_audio_samples - remaining) / 2;
+}
+
+// The HAL has only a half and a complete callback, but the ring can have any number of periods.
+// So on each callback check where the DMA actually is (NDTR) and refill every period
+// which was already played. This way a delayed callback still refills everything it can.
+// 'event_pos' is the DMA position (in samples) where the callback was triggered
+static void service_periods(uint32_t event_pos) {
+    const uint32_t pos = dma_sample_pos();
+    const uint8_t play_period = (pos / samp_all_channels) % AUDIO_PERIOD_CNT;
+
+    // how long it took from the DMA event to get here
+    const uint32_t delay = (pos + total_audio_samples - event_pos) % total_audio_samples;
+    if (delay > samp_all_channels / 2) {
+        ++i2s_period_stats.late;
+    }
+
+    while (fill_period != play_period) {
+        loadMore(fill_period);
+        ++i2s_period_stats.filled;
+
+        ++fill_period;
+        if (fill_period >= AUDIO_PERIOD_CNT) {
+            fill_period = 0;
+        }
     }
 }
 
 void HAL_I2S_TxHalfCpltCallback(I2S_HandleTypeDef *hi2s) {
-    buffStatus = SEND_2ND_HALF_FILL_1ST;
-    loadMore();
+    service_periods(total_audio_samples / 2);
 }
 
 void HAL_I2S_TxCpltCallback(I2S_HandleTypeDef *hi2s) {
-    buffStatus = SEND_1ST_HALF_FILL_2ND;
-    loadMore();
+    service_periods(0);
+}
+
+
+uint16_t audio_get_period_pos_frames(void) {
+    if (isFirst) {
+        return 0;
+    }
+    return (dma_sample_pos() % samp_all_channels) / 2;
 }
 
+uint16_t audio_get_played_frames(uint16_t elapsed_ms) {
+    // the DMA is started only on the 1st play
+    if (isFirst) {
+        return 0;
+    }
+
+    const uint32_t pos = dma_sample_pos();
+    uint32_t played = (pos + total_audio_samples - last_pos) % total_audio_samples;
+    last_pos = pos;
+
+    // The position shows the time only modulo the ring (2ms by default), the whole rings played
+    // meanwhile are added back from the elapsed time at the nominal rate.
+    // The I2S is off by a few 100ppm at most, that is far from half a ring for any realistic gap.
+    const uint32_t expected = sample_rate / 100 * elapsed_ms / 10 * 2;
+    if (expected > played + total_audio_samples / 2) {
+        played += (expected - played + total_audio_samples / 2) / total_audio_samples * total_audio_samples;
+    }
+
+    // 2 channels per frame
+    return MIN(played / 2, UINT16_MAX);
+}
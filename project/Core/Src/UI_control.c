@@ -60,6 +60,9 @@ typedef enum {
 	PAGE_TREBLE_FREQ,
 	PAGE_BALANCE,
 	PAGE_ANALOG_GAIN,
+	PAGE_CROSSFEED,
+	PAGE_LOUDNESS,
+	PAGE_EQ,
 
 	PAGE_CNT
 } UiPage;
@@ -73,6 +76,9 @@ _Static_assert((int)PAGE_BASS_FREQ == (int)AUDIO_CONTROL_BASS_FREQ, "UiPage must
 _Static_assert((int)PAGE_TREBLE_FREQ == (int)AUDIO_CONTROL_TREB_FREQ, "UiPage must be in sync with AudioControl");
 _Static_assert((int)PAGE_BALANCE == (int)AUDIO_CONTROL_BALANCE, "UiPage must be in sync with AudioControl");
 _Static_assert((int)PAGE_ANALOG_GAIN == (int)AUDIO_CONTROL_ANALOG_GAIN, "UiPage must be in sync with AudioControl");
+_Static_assert((int)PAGE_CROSSFEED == (int)AUDIO_CONTROL_CROSSFEED, "UiPage must be in sync with AudioControl");
+_Static_assert((int)PAGE_LOUDNESS == (int)AUDIO_CONTROL_LOUDNESS, "UiPage must be in sync with AudioControl");
+_Static_assert((int)PAGE_EQ == (int)AUDIO_CONTROL_EQ, "UiPage must be in sync with AudioControl");
 
 
 static void key_pressed(Button btn);
@@ -197,6 +203,33 @@ static void show_page(UiPage page) {
 			get_audio_value_str(AUDIO_CONTROL_ANALOG_GAIN, &string_ptr);
 			SSD1306_Puts(string_ptr, &Font_16x26, SSD1306_PX_CLR_WHITE);
 			break;
+
+	case PAGE_CROSSFEED:
+		SSD1306_GotoXY(14, 0);
+		SSD1306_Puts("Crossfeed", &Font_11x18, SSD1306_PX_CLR_WHITE);
+
+		SSD1306_GotoXY(24, 37);
+		get_audio_value_str(AUDIO_CONTROL_CROSSFEED, &string_ptr);
+		SSD1306_Puts(string_ptr, &Font_16x26, SSD1306_PX_CLR_WHITE);
+		break;
+
+	case PAGE_LOUDNESS:
+		SSD1306_GotoXY(20, 0);
+		SSD1306_Puts("Loudness", &Font_11x18, SSD1306_PX_CLR_WHITE);
+
+		SSD1306_GotoXY(40, 37);
+		get_audio_value_str(AUDIO_CONTROL_LOUDNESS, &string_ptr);
+		SSD1306_Puts(string_ptr, &Font_16x26, SSD1306_PX_CLR_WHITE);
+		break;
+
+	case PAGE_EQ:
+		SSD1306_GotoXY(53, 0);
+		SSD1306_Puts("EQ", &Font_11x18, SSD1306_PX_CLR_WHITE);
+
+		SSD1306_GotoXY(24, 37);
+		get_audio_value_str(AUDIO_CONTROL_EQ, &string_ptr);
+		SSD1306_Puts(string_ptr, &Font_16x26, SSD1306_PX_CLR_WHITE);
+		break;
 	}
 
 	SSD1306_UpdateScreen();
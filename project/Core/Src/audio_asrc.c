@@ -0,0 +1,166 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "audio_asrc.h"
+#include "audio_common.h"
+#include "custom_math.h"
+
+// the FIFO level is averaged over 2^ASRC_BLOCK_SHIFT refills (64ms with 1ms periods)
+#define ASRC_BLOCK_SHIFT   6
+#define ASRC_BLOCK_LEN     (1 << ASRC_BLOCK_SHIFT)
+
+// 1ppm as 0.32
+#define ASRC_PPM           4295
+
+// PI gains per frame of FIFO error
+//  - P: 4ppm, 10 frames off gives 40ppm
+//  - I: 0.1ppm per block, removes the offset of the clock drift
+// simulated with +-500ppm host drift, the FIFO settles in ~30s and stays within +-1 frame
+#define ASRC_KP            (4 * ASRC_PPM)
+#define ASRC_KI            (ASRC_PPM / 10)
+
+// far more than any real clock drift
+#define ASRC_MAX_ADJ       (2000 * ASRC_PPM)
+
+// 24bit output range, the cubic can overshoot a full scale input
+#define ASRC_OUT_MAX       ((1 << 23) - 1)
+#define ASRC_OUT_MIN       (-(1 << 23))
+
+void audio_asrc_init(AudioAsrc *st, uint16_t fifo_target_frames) {
+	st->phase = 0;
+	st->ratio_adj = 0;
+	st->target_frames = fifo_target_frames;
+	st->fifo_sum = 0;
+	st->block_cnt = 0;
+	st->integ = 0;
+	st->fifo_err = 0;
+}
+
+void audio_asrc_update(AudioAsrc *st, uint16_t fifo_frames) {
+	st->fifo_sum += fifo_frames;
+	if (++st->block_cnt < ASRC_BLOCK_LEN) {
+		return;
+	}
+
+	// FIFO is above the target -> consume more
+	st->fifo_err = (int32_t)(st->fifo_sum >> ASRC_BLOCK_SHIFT) - (int32_t)st->target_frames;
+	st->fifo_sum = 0;
+	st->block_cnt = 0;
+
+	st->integ += st->fifo_err * ASRC_KI;
+	st->integ = MIN(st->integ, ASRC_MAX_ADJ);
+	st->integ = MAX(st->integ, -ASRC_MAX_ADJ);
+
+	int32_t adj = st->integ + st->fifo_err * ASRC_KP;
+	adj = MIN(adj, ASRC_MAX_ADJ);
+	adj = MAX(adj, -ASRC_MAX_ADJ);
+	st->ratio_adj = adj;
+}
+
+uint16_t audio_asrc_needed(const AudioAsrc *st, uint16_t out_frames) {
+	if (out_frames == 0) {
+		return 0;
+	}
+
+	// position of the last interpolation point, it needs 1 frame before and 2 after
+	const uint64_t step = (1ULL << 32) + (int64_t)st->ratio_adj;
+	const uint32_t last = (uint32_t)((st->phase + step * (out_frames - 1)) >> 32);
+	return AUDIO_ASRC_HIST_FRAMES + last + 3;
+}
+
+// Catmull-Rom between x0 and x1, 't' is 0.16
+static inline int32_t cubic(int32_t xm1, int32_t x0, int32_t x1, int32_t x2, int32_t t) {
+	const int32_t a = (3 * (x0 - x1) + x2 - xm1) / 2;
+	const int32_t b = 2 * x1 + xm1 - (5 * x0 + x2) / 2;
+	const int32_t c = (x1 - xm1) / 2;
+
+	int32_t y = (int32_t)(((int64_t)a * t) >> 16) + b;
+	y = (int32_t)(((int64_t)y * t) >> 16) + c;
+	y = (int32_t)(((int64_t)y * t) >> 16) + x0;
+
+	y = MIN(y, ASRC_OUT_MAX);
+	y = MAX(y, ASRC_OUT_MIN);
+	return y;
+}
+
+uint16_t audio_asrc_process(AudioAsrc *st, const int32_t *in, uint16_t in_frames,
+		int32_t *out, uint16_t out_frames, uint16_t *consumed) {
+	const uint64_t step = (1ULL << 32) + (int64_t)st->ratio_adj;
+	uint64_t pos = st->phase; // 32.32 position relative to in[AUDIO_ASRC_HIST_FRAMES]
+	uint16_t n = 0;
+
+	while (n < out_frames) {
+		const uint32_t idx = AUDIO_ASRC_HIST_FRAMES + (uint32_t)(pos >> 32);
+		if (idx + 2 >= in_frames) {
+			break;
+		}
+
+		const int32_t *x = &in[2 * (idx - 1)];
+		const int32_t t = (int32_t)((uint32_t)pos >> 16);
+
+		// on 24bit values, so the polynomial fits into 32bit
+		out[2 * n + 0] = cubic(x[0] >> 8, x[2] >> 8, x[4] >> 8, x[6] >> 8, t) << 8;
+		out[2 * n + 1] = cubic(x[1] >> 8, x[3] >> 8, x[5] >> 8, x[7] >> 8, t) << 8;
+
+		++n;
+		pos += step;
+	}
+
+	// keep the history before the next interpolation point
+	const uint16_t drop = (uint16_t)(pos >> 32);
+	*consumed = MIN(drop, in_frames - AUDIO_ASRC_HIST_FRAMES);
+	st->phase = (uint32_t)pos;
+	return n;
+}
+
+#if CFG_AUDIO_BENCHMARK
+#include "cycle_counter.h"
+#include <stdio.h>
+
+// 1ms of stereo audio
+#define BENCH_FRAMES 48
+
+void audio_asrc_benchmark(void) {
+	static int32_t in[2 * (BENCH_FRAMES + 8)];
+	static int32_t out[2 * BENCH_FRAMES];
+	AudioAsrc st;
+	uint16_t consumed;
+
+	for (uint16_t i = 0; i < 2 * (BENCH_FRAMES + 8); ++i) {
+		in[i] = (int32_t)(i * 0x01234567u) & (int32_t)0xFFFFFF00;
+	}
+
+	audio_asrc_init(&st, 0);
+	st.ratio_adj = 500 * ASRC_PPM;
+
+	cycle_counter_init();
+	const uint32_t start = cycle_counter_get();
+	const uint16_t n = audio_asrc_process(&st, in, BENCH_FRAMES + 8, out, BENCH_FRAMES, &consumed);
+	const uint32_t cycles = cycle_counter_get() - start;
+
+	printf("asrc: %u frames, %lu cycles, %lu cycles/sample\n", n, cycles, cycles / (2 * BENCH_FRAMES));
+}
+#endif
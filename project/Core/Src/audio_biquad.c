@@ -0,0 +1,208 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "audio_biquad.h"
+#include "audio_common.h"
+#include <math.h>
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+// SMLAL: 64bit += 32x32, 1 cycle on the M4
+static inline int64_t smlal(int64_t acc, int32_t a, int32_t b) {
+	uint32_t lo = (uint32_t)acc;
+	uint32_t hi = (uint32_t)((uint64_t)acc >> 32);
+	__asm__ ("smlal %0, %1, %2, %3" : "+r" (lo), "+r" (hi) : "r" (a), "r" (b));
+	return (int64_t)(((uint64_t)hi << 32) | lo);
+}
+#else
+// host build, so the kernel can be checked against the reference on a PC
+static inline int64_t smlal(int64_t acc, int32_t a, int32_t b) {
+	return acc + (int64_t)a * b;
+}
+#endif
+
+// accumulator back to Q31 with saturation
+static inline int32_t acc_to_q31(int64_t acc, uint8_t shift) {
+	const int64_t y = acc >> (31 - shift);
+	if (y > INT32_MAX) {
+		return INT32_MAX;
+	}
+	if (y < INT32_MIN) {
+		return INT32_MIN;
+	}
+	return (int32_t)y;
+}
+
+void audio_biquad_to_q31(const AudioBiquad *in, AudioBiquadQ31Coef *out) {
+	const float c[5] = { in->b0, in->b1, in->b2, -in->a1, -in->a2 };
+
+	// the smallest scaling where all coefficients are below 2^shift
+	float max = 0.0f;
+	for (uint8_t i = 0; i < 5; ++i) {
+		max = fmaxf(max, fabsf(c[i]));
+	}
+	uint8_t shift = 0;
+	while ((shift < 7) && (max >= (float)(1 << shift))) {
+		++shift;
+	}
+
+	int32_t q[5];
+	const float scale = 2147483648.0f / (float)(1 << shift);
+	for (uint8_t i = 0; i < 5; ++i) {
+		const float v = roundf(c[i] * scale);
+		q[i] = (v >= 2147483520.0f) ? INT32_MAX : (int32_t)v;
+	}
+
+	out->b0 = q[0];
+	out->b1 = q[1];
+	out->b2 = q[2];
+	out->a1 = q[3];
+	out->a2 = q[4];
+	out->shift = shift;
+}
+
+void audio_biquad_cascade_ref(int32_t *buf, uint16_t n_frames, AudioBiquadQ31 *stages, uint8_t n_stages) {
+	for (uint16_t i = 0; i < 2 * n_frames; ++i) {
+		int32_t x = buf[i];
+
+		for (uint8_t s = 0; s < n_stages; ++s) {
+			const AudioBiquadQ31Coef *c = &stages[s].coef;
+			AudioBiquadQ31State *st = &stages[s].st[i & 1];
+
+			int64_t acc = (int64_t)c->b0 * x;
+			acc += (int64_t)c->b1 * st->x1;
+			acc += (int64_t)c->b2 * st->x2;
+			acc += (int64_t)c->a1 * st->y1;
+			acc += (int64_t)c->a2 * st->y2;
+			const int32_t y = acc_to_q31(acc, c->shift);
+
+			st->x2 = st->x1;
+			st->x1 = x;
+			st->y2 = st->y1;
+			st->y1 = y;
+			x = y;
+		}
+
+		buf[i] = x;
+	}
+}
+
+void audio_biquad_stereo(int32_t *buf, uint16_t n_frames, AudioBiquadQ31 *stage) {
+	const int32_t b0 = stage->coef.b0, b1 = stage->coef.b1, b2 = stage->coef.b2;
+	const int32_t a1 = stage->coef.a1, a2 = stage->coef.a2;
+	const uint8_t shift = stage->coef.shift;
+
+	int32_t lx1 = stage->st[0].x1, lx2 = stage->st[0].x2, ly1 = stage->st[0].y1, ly2 = stage->st[0].y2;
+	int32_t rx1 = stage->st[1].x1, rx2 = stage->st[1].x2, ry1 = stage->st[1].y1, ry2 = stage->st[1].y2;
+
+	for (uint16_t i = 0; i < n_frames; ++i) {
+		const int32_t xl = buf[2 * i + 0];
+		const int32_t xr = buf[2 * i + 1];
+
+		// the two accumulators are independent, the MACs alternate between them
+		int64_t accl = (int64_t)b0 * xl;
+		int64_t accr = (int64_t)b0 * xr;
+		accl = smlal(accl, b1, lx1);
+		accr = smlal(accr, b1, rx1);
+		accl = smlal(accl, b2, lx2);
+		accr = smlal(accr, b2, rx2);
+		accl = smlal(accl, a1, ly1);
+		accr = smlal(accr, a1, ry1);
+		accl = smlal(accl, a2, ly2);
+		accr = smlal(accr, a2, ry2);
+
+		const int32_t yl = acc_to_q31(accl, shift);
+		const int32_t yr = acc_to_q31(accr, shift);
+
+		lx2 = lx1;
+		lx1 = xl;
+		ly2 = ly1;
+		ly1 = yl;
+		rx2 = rx1;
+		rx1 = xr;
+		ry2 = ry1;
+		ry1 = yr;
+
+		buf[2 * i + 0] = yl;
+		buf[2 * i + 1] = yr;
+	}
+
+	stage->st[0].x1 = lx1;
+	stage->st[0].x2 = lx2;
+	stage->st[0].y1 = ly1;
+	stage->st[0].y2 = ly2;
+	stage->st[1].x1 = rx1;
+	stage->st[1].x2 = rx2;
+	stage->st[1].y1 = ry1;
+	stage->st[1].y2 = ry2;
+}
+
+void audio_biquad_cascade(int32_t *buf, uint16_t n_frames, AudioBiquadQ31 *stages, uint8_t n_stages) {
+	for (uint8_t s = 0; s < n_stages; ++s) {
+		audio_biquad_stereo(buf, n_frames, &stages[s]);
+	}
+}
+
+#if CFG_AUDIO_BENCHMARK
+#include "cycle_counter.h"
+#include <stdio.h>
+#include <string.h>
+
+// 1ms of stereo audio
+#define BENCH_FRAMES 48
+#define BENCH_STAGES 5
+
+void audio_biquad_benchmark(void) {
+	static int32_t buf_ref[2 * BENCH_FRAMES];
+	static int32_t buf[2 * BENCH_FRAMES];
+	static AudioBiquadQ31 st_ref[BENCH_STAGES];
+	static AudioBiquadQ31 st[BENCH_STAGES];
+
+	// a 1kHz +3dB peak at 48kHz
+	const AudioBiquad peak = { 1.0145f, -1.9490f, 0.9389f, -1.9490f, 0.9534f };
+	for (uint8_t s = 0; s < BENCH_STAGES; ++s) {
+		audio_biquad_to_q31(&peak, &st_ref[s].coef);
+	}
+	memcpy(st, st_ref, sizeof(st));
+
+	for (uint16_t i = 0; i < 2 * BENCH_FRAMES; ++i) {
+		buf_ref[i] = (int32_t)(i * 0x01234567u) & (int32_t)0xFFFFFF00;
+	}
+	memcpy(buf, buf_ref, sizeof(buf));
+
+	cycle_counter_init();
+
+	uint32_t start = cycle_counter_get();
+	audio_biquad_cascade_ref(buf_ref, BENCH_FRAMES, st_ref, BENCH_STAGES);
+	const uint32_t cycles_ref = cycle_counter_get() - start;
+
+	start = cycle_counter_get();
+	audio_biquad_cascade(buf, BENCH_FRAMES, st, BENCH_STAGES);
+	const uint32_t cycles = cycle_counter_get() - start;
+
+	printf("biquad %u stages: ref %lu, block %lu cycles (%lu/sample), %s\n", BENCH_STAGES, cycles_ref, cycles,
+			cycles / (2 * BENCH_FRAMES), memcmp(buf_ref, buf, sizeof(buf)) == 0 ? "match" : "MISMATCH");
+}
+#endif
@@ -27,7 +27,14 @@
 
 #include "audio_controls.h"
 #include "CS43L22_driver.h"
+#include "audio_volume.h"
+#include "audio_crossfeed.h"
+#include "audio_eq.h"
+#include "audio_limiter.h"
+#include "audio_loudness.h"
+#include "audio_tone.h"
 #include "custom_math.h"
+#include "stm32f4xx_hal.h"
 #include <stdio.h> // sprintf()
 
 #define DIVISOR 	10
@@ -53,8 +60,27 @@
 
 int16_t control_value[AUDIO_CONTROL_CNT];
 
+// the L and R feature unit channels of the host, on top of the master volume/mute (control_value)
+// the volume is in the same range as the master, its max is no attenuation
+static int16_t channel_volume[2] = { SYSTEM_MAX_VOLUME_DB * DIVISOR, SYSTEM_MAX_VOLUME_DB * DIVISOR };
+static int8_t channel_mute[2];
+
+// The host's controls (USB control requests) only change the values above and mark the control here,
+// audio_controls_task() sends the latest values to the codec, so a slider burst is a few codec updates
+// and tud_task() never waits for the I2C. Both run from the main loop, so no locking is needed.
+static uint32_t pending_controls;   // bit per AudioControl
+static uint32_t last_sync_ms;
+
+AudioControlStats audio_control_stats;
+
+static void request_update(AudioControl control) {
+	pending_controls |= 1u << control;
+	++audio_control_stats.requests;
+}
+
 const char *const bass_freqs[TONE_FREQ_CNT] = { " 50Hz", "100Hz", "200Hz", "250Hz" };
 const char *const treb_freqs[TONE_FREQ_CNT] = { " 5kHz", " 7kHz", "10kHz", "15kHz" };
+const char *const on_off[2] = { "Off", " On" };
 const char *const hp_analog_gains[HP_ANA_GAIN_CNT] = {
 		"0.40dB",
 		"0.46dB",
@@ -86,9 +112,10 @@ static inline int16_t convert_to_CS43L22_vol(int16_t volume) {
 	return volume / (DIVISOR / 2);
 }
 
+// the master volume, the host's L/R channel volumes and the on-device balance merged into one L and R setting
 static void send_volume_with_blnc(void) {
-	int16_t vol_L = control_value[AUDIO_CONTROL_VOLUME];
-	int16_t vol_R = control_value[AUDIO_CONTROL_VOLUME];
+	int16_t vol_L = control_value[AUDIO_CONTROL_VOLUME] + channel_volume[0] - SYSTEM_MAX_VOLUME_DB * DIVISOR;
+	int16_t vol_R = control_value[AUDIO_CONTROL_VOLUME] + channel_volume[1] - SYSTEM_MAX_VOLUME_DB * DIVISOR;
 	int16_t blnc = control_value[AUDIO_CONTROL_BALANCE];
 
 	if (blnc < 0) {
@@ -97,41 +124,87 @@ static void send_volume_with_blnc(void) {
 		vol_L -= blnc;
 	}
 
+#if CFG_AUDIO_LOUDNESS
+	// the loudness filters only cut (the mid and high frequencies), the stage makes it up with its own gain,
+	// the digital volume before it leaves the headroom for that
+	static int16_t makeup_set;
+	const int16_t makeup = audio_loudness_get_makeup_db_x10(control_value[AUDIO_CONTROL_VOLUME]);
+	audio_volume_set_headroom_db_x10(makeup);
+	// a smaller makeup before the headroom goes away, a larger one after it is there (both are smoothed alike)
+	if (makeup < makeup_set) {
+		audio_loudness_set_volume_db_x10(control_value[AUDIO_CONTROL_VOLUME]);
+	}
+#endif
+
+#if CFG_AUDIO_DIGITAL_VOLUME
+	// the fine part is done in the refill, the codec gets only the coarse steps
+	audio_volume_set_db_x10(vol_L, vol_R);
+#if CFG_AUDIO_LOUDNESS
+	if (makeup >= makeup_set) {
+		audio_loudness_set_volume_db_x10(control_value[AUDIO_CONTROL_VOLUME]);
+	}
+	makeup_set = makeup;
+#endif
+#else
 	// scale it to 0.5dB step format for CS43L22
 	CS43L22_set_hp_volume_db(
 			convert_to_CS43L22_vol(vol_L),
 			convert_to_CS43L22_vol(vol_R));
+#endif
+}
+
+// the tone tables are for one sample rate, at the others the codec does it
+static inline bool soft_tone(void) {
+	return CFG_AUDIO_SOFT_TONE && audio_tone_available();
 }
 
 static void update_audio_codec(AudioControl control) {
 	switch (control) {
 	case AUDIO_CONTROL_MUTE:
-		CS43L22_set_hp_mute(control_value[AUDIO_CONTROL_MUTE]);
+		CS43L22_set_hp_mute(
+				control_value[AUDIO_CONTROL_MUTE] || channel_mute[0],
+				control_value[AUDIO_CONTROL_MUTE] || channel_mute[1]);
 		break;
 
 	case AUDIO_CONTROL_BASS:
 	case AUDIO_CONTROL_TREB:
-		CS43L22_set_bass_treb_gain(
-				convert_to_tone_gain(control_value[AUDIO_CONTROL_BASS]),
-				convert_to_tone_gain(control_value[AUDIO_CONTROL_TREB]));
+		if (soft_tone()) {
+			// precomputed shelves, no I2C
+			audio_tone_set_bass(control_value[AUDIO_CONTROL_BASS_FREQ], control_value[AUDIO_CONTROL_BASS]);
+			audio_tone_set_treble(control_value[AUDIO_CONTROL_TREB_FREQ], control_value[AUDIO_CONTROL_TREB]);
+		} else {
+			CS43L22_set_bass_treb_gain(
+					convert_to_tone_gain(control_value[AUDIO_CONTROL_BASS]),
+					convert_to_tone_gain(control_value[AUDIO_CONTROL_TREB]));
+		}
 
 		// if the tone is set to positive gain it can clip,
-		// so decrease the gain before the tone control (master volume)
 		int16_t tone_gain_max = MAX(control_value[AUDIO_CONTROL_BASS],
 									control_value[AUDIO_CONTROL_TREB]);
 
 		// do not increase volume when tone gain is negative
 		tone_gain_max = MAX(0, tone_gain_max);
 
+#if CFG_AUDIO_LIMITER
+		// so only the peaks which would clip after the boost are limited, the rest keeps the full level
+		audio_limiter_set_ceiling_db_x10(-tone_gain_max);
+#else
+		// so decrease the gain before the tone control (master volume)
 		// scale it to 0.5dB step format for CS43L22
 		CS43L22_set_master_volume_db(convert_to_CS43L22_vol(-tone_gain_max));
+#endif
 
 		break;
 
 	case AUDIO_CONTROL_BASS_FREQ:
 	case AUDIO_CONTROL_TREB_FREQ:
-		CS43L22_set_bass_treb_freq(control_value[AUDIO_CONTROL_BASS_FREQ],
-				control_value[AUDIO_CONTROL_TREB_FREQ]);
+		if (soft_tone()) {
+			audio_tone_set_bass(control_value[AUDIO_CONTROL_BASS_FREQ], control_value[AUDIO_CONTROL_BASS]);
+			audio_tone_set_treble(control_value[AUDIO_CONTROL_TREB_FREQ], control_value[AUDIO_CONTROL_TREB]);
+		} else {
+			CS43L22_set_bass_treb_freq(control_value[AUDIO_CONTROL_BASS_FREQ],
+					control_value[AUDIO_CONTROL_TREB_FREQ]);
+		}
 		break;
 
 	case AUDIO_CONTROL_VOLUME:
@@ -142,6 +215,22 @@ static void update_audio_codec(AudioControl control) {
 	case AUDIO_CONTROL_ANALOG_GAIN:
 		CS43L22_set_hp_analog_gain(control_value[AUDIO_CONTROL_ANALOG_GAIN]);
 		break;
+
+	case AUDIO_CONTROL_CROSSFEED:
+		// not in the codec, but in the refill
+		audio_crossfeed_set_preset(control_value[AUDIO_CONTROL_CROSSFEED]);
+		break;
+
+	case AUDIO_CONTROL_LOUDNESS:
+		audio_loudness_enable(control_value[AUDIO_CONTROL_LOUDNESS]);
+		// the makeup gain changes with it
+		send_volume_with_blnc();
+		break;
+
+	case AUDIO_CONTROL_EQ:
+		// not in the codec, but in the refill
+		audio_eq_set_preset(control_value[AUDIO_CONTROL_EQ]);
+		break;
 	}
 }
 
@@ -160,25 +249,59 @@ static inline int16_t vol_db_div_to_usb_pct(int16_t volume_db_div) {
 	 return (int16_t)pct;
 }
 
-void audio_set_volume_usb_pct(int16_t volume_pct) {
+// the volume of a USB feature unit channel, dB with DIVISOR
+static inline int16_t* channel_volume_of(uint8_t channel) {
+	return channel == 0 ? &control_value[AUDIO_CONTROL_VOLUME] : &channel_volume[channel - 1];
+}
+
+void audio_set_volume_usb_pct(uint8_t channel, int16_t volume_pct) {
 	// volume is special. HW supports -102dB +12dB/0dB range, but on USB level we map it to 0-100% range with 0.5% step
 	// internally we convert it to the dB with DIVISOR
-	control_value[AUDIO_CONTROL_VOLUME] = vol_usb_pct_to_db_div(volume_pct);
-	printf("volume is: %d\n", control_value[AUDIO_CONTROL_VOLUME]);
-	update_audio_codec(AUDIO_CONTROL_VOLUME);
+	*channel_volume_of(channel) = vol_usb_pct_to_db_div(volume_pct);
+	request_update(AUDIO_CONTROL_VOLUME);
+}
+
+int16_t audio_get_volume_usb_pct(uint8_t channel) {
+	return vol_db_div_to_usb_pct(*channel_volume_of(channel));
 }
 
-int16_t audio_get_volume_usb_pct(void) {
-	return vol_db_div_to_usb_pct(control_value[AUDIO_CONTROL_VOLUME]);
+// UAC2 volume, 1/256dB (-32768 is silence)
+// 0.5dB steps, those are exact in the internal 0.1dB so the host reads back what it has set
+#define VOLUME_RES_DB_256     (256 / 2)
+
+_Static_assert(((SYSTEM_MAX_VOLUME_DB - SYSTEM_MIN_VOLUME_DB) * 256) % VOLUME_RES_DB_256 == 0, "the range has to be whole steps");
+
+void audio_set_volume_db_256(uint8_t channel, int16_t volume) {
+	// rounded to the nearest 0.1dB
+	int32_t db_div = ((int32_t)volume * DIVISOR + (volume < 0 ? -128 : 128)) / 256;
+	db_div = MIN(db_div, SYSTEM_MAX_VOLUME_DB * DIVISOR);
+	db_div = MAX(db_div, SYSTEM_MIN_VOLUME_DB * DIVISOR);
+
+	*channel_volume_of(channel) = (int16_t)db_div;
+	request_update(AUDIO_CONTROL_VOLUME);
+}
+
+int16_t audio_get_volume_db_256(uint8_t channel) {
+	return (int16_t)((int32_t)*channel_volume_of(channel) * 256 / DIVISOR);
+}
+
+void audio_get_volume_range_db_256(int16_t *min, int16_t *max, int16_t *res) {
+	*min = SYSTEM_MIN_VOLUME_DB * 256;
+	*max = SYSTEM_MAX_VOLUME_DB * 256;
+	*res = VOLUME_RES_DB_256;
 }
 
-void audio_set_mute(int8_t mute) {
-	control_value[AUDIO_CONTROL_MUTE] = mute;
-	update_audio_codec(AUDIO_CONTROL_MUTE);
+void audio_set_mute(uint8_t channel, int8_t mute) {
+	if (channel == 0) {
+		control_value[AUDIO_CONTROL_MUTE] = mute;
+	} else {
+		channel_mute[channel - 1] = mute;
+	}
+	request_update(AUDIO_CONTROL_MUTE);
 }
 
-int8_t audio_get_mute(void) {
-	return control_value[AUDIO_CONTROL_MUTE];
+int8_t audio_get_mute(uint8_t channel) {
+	return channel == 0 ? control_value[AUDIO_CONTROL_MUTE] : channel_mute[channel - 1];
 }
 
 static int16_t get_blnc_step() {
@@ -224,6 +347,26 @@ void audio_increase(AudioControl control) {
 		}
 		break;
 
+	case AUDIO_CONTROL_CROSSFEED:
+		control_value[control] += 1;
+		if (control_value[control] >= AUDIO_CROSSFEED_PRESET_CNT) {
+			control_value[control] = AUDIO_CROSSFEED_PRESET_CNT - 1;
+		}
+		break;
+
+	case AUDIO_CONTROL_LOUDNESS:
+#if CFG_AUDIO_LOUDNESS
+		control_value[control] = 1;
+#endif
+		break;
+
+	case AUDIO_CONTROL_EQ:
+		control_value[control] += 1;
+		if (control_value[control] >= AUDIO_EQ_PRESET_CNT) {
+			control_value[control] = AUDIO_EQ_PRESET_CNT - 1;
+		}
+		break;
+
 	default:
 		return;
 	}
@@ -257,6 +400,9 @@ void audio_decrease(AudioControl control) {
 		break;
 
 	case AUDIO_CONTROL_ANALOG_GAIN:
+	case AUDIO_CONTROL_CROSSFEED:
+	case AUDIO_CONTROL_LOUDNESS:
+	case AUDIO_CONTROL_EQ:
 		control_value[control] -= 1;
 		if (control_value[control] < 0) {
 			control_value[control] = 0;
@@ -276,6 +422,9 @@ void audio_init() {
 	control_value[AUDIO_CONTROL_TREB] = 1.5 * 2 * DIVISOR; // 1.5 step x 2 = +3dB
 	control_value[AUDIO_CONTROL_BASS_FREQ] = 1; // 100Hz
 	control_value[AUDIO_CONTROL_ANALOG_GAIN] = 3; // 0.6047dB
+	control_value[AUDIO_CONTROL_CROSSFEED] = AUDIO_CROSSFEED_OFF;
+	control_value[AUDIO_CONTROL_LOUDNESS] = 0;
+	control_value[AUDIO_CONTROL_EQ] = AUDIO_EQ_FLAT;
 
 
 	update_audio_codec(AUDIO_CONTROL_VOLUME);
@@ -285,6 +434,44 @@ void audio_init() {
 	update_audio_codec(AUDIO_CONTROL_BASS_FREQ);
 }
 
+void audio_controls_task(void) {
+	if (pending_controls == 0) {
+		return;
+	}
+	// the first change of a burst goes out right away, the rest is collected for AUDIO_CONTROL_SYNC_MS
+	const uint32_t now = HAL_GetTick();
+	if (now - last_sync_ms < AUDIO_CONTROL_SYNC_MS) {
+		return;
+	}
+	last_sync_ms = now;
+
+	const uint32_t pending = pending_controls;
+	pending_controls = 0;
+	++audio_control_stats.codec_syncs;
+
+	if (pending & (1u << AUDIO_CONTROL_VOLUME)) {
+		printf("volume is: %d L: %d R: %d\n", control_value[AUDIO_CONTROL_VOLUME], channel_volume[0], channel_volume[1]);
+		update_audio_codec(AUDIO_CONTROL_VOLUME);
+	}
+	if (pending & (1u << AUDIO_CONTROL_MUTE)) {
+		printf("mute is: %d L: %d R: %d\n", control_value[AUDIO_CONTROL_MUTE], channel_mute[0], channel_mute[1]);
+		update_audio_codec(AUDIO_CONTROL_MUTE);
+	}
+}
+
+void audio_controls_sample_rate_changed(void) {
+#if CFG_AUDIO_SOFT_TONE
+	// the tone may have moved between the codec and the pipeline, the unused one is flat
+	if (soft_tone()) {
+		CS43L22_set_bass_treb_gain(convert_to_tone_gain(0), convert_to_tone_gain(0));
+	}
+#endif
+	update_audio_codec(AUDIO_CONTROL_BASS);
+	update_audio_codec(AUDIO_CONTROL_BASS_FREQ);
+	// the loudness may be unavailable at the new rate, so the makeup too
+	update_audio_codec(AUDIO_CONTROL_VOLUME);
+}
+
 //------------------------------------------------------------------------------
 //-------------------------- string formatters for UI --------------------------
 //------------------------------------------------------------------------------
@@ -341,6 +528,18 @@ void get_audio_value_str(AudioControl control, char **ptr) {
 		*ptr = hp_analog_gains[current_value];
 		break;
 
+	case AUDIO_CONTROL_CROSSFEED:
+		*ptr = audio_crossfeed_presets[current_value].name;
+		break;
+
+	case AUDIO_CONTROL_LOUDNESS:
+		*ptr = on_off[current_value];
+		break;
+
+	case AUDIO_CONTROL_EQ:
+		*ptr = audio_eq_presets[current_value].name;
+		break;
+
 	default:
 		*ptr = 0;
 	}
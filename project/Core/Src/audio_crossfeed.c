@@ -0,0 +1,184 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "audio_crossfeed.h"
+#include "audio_eq.h"
+#include "audio_common.h"
+#include "audio_params.h"
+#include <math.h>
+#include <string.h>
+
+const AudioCrossfeedParams audio_crossfeed_presets[AUDIO_CROSSFEED_PRESET_CNT] = {
+	[AUDIO_CROSSFEED_OFF]     = { "  Off",   0.0f, 0.0f,   0.0f },
+	[AUDIO_CROSSFEED_MEIER]   = { "Meier", 650.0f, 9.5f, 250.0f },
+	[AUDIO_CROSSFEED_CHU_MOY] = { "C.Moy", 700.0f, 6.0f, 280.0f },
+	[AUDIO_CROSSFEED_BS2B]    = { " bs2b", 700.0f, 4.5f, 300.0f },
+};
+
+static float fs;
+static AudioCrossfeedPreset preset_cur;
+
+// used by the refill
+static AudioCrossfeedCoef coef;
+static AudioBiquadQ31 lp;
+
+// written by audio_crossfeed_set_preset(), taken over at the next block
+static AudioCrossfeedCoef params_buf[2];
+static AudioParams params;
+
+// low passed input for the delay, the last AUDIO_CROSSFEED_MAX_DELAY + 1 frames of the previous block
+// are in front of the current block
+#define HIST_FRAMES             (AUDIO_CROSSFEED_MAX_DELAY + 1)
+static int32_t hist[2 * (HIST_FRAMES + AUDIO_PIPELINE_BLOCK_FRAMES)];
+
+AudioStage audio_crossfeed_stage = {
+	.name = "crossfeed",
+	.process = audio_crossfeed_process,
+	.reset = audio_crossfeed_reset,
+	.set_sample_rate = audio_crossfeed_set_sample_rate,
+	.enable_req = false,
+};
+
+void audio_crossfeed_calc(const AudioCrossfeedParams *p, float sample_rate, AudioCrossfeedCoef *c) {
+	// the direct path is x - feed * lp(x), so direct + cross = 1 at DC and the direct path is flat above the cutoff
+	const float cross_gain = powf(10.0f, -p->feed_db / 20.0f);
+	const float feed = cross_gain / (1.0f + cross_gain);
+
+	// critically damped (Q = 0.5), so there is no bump in the cross path
+	const AudioEqBand band = { .enabled = true, .type = AUDIO_EQ_LOW_PASS, .freq = p->cutoff, .q = 0.5f };
+	AudioBiquad bq;
+	audio_eq_calc_biquad(&band, sample_rate, &bq);
+	bq.b0 *= feed;
+	bq.b1 *= feed;
+	bq.b2 *= feed;
+	audio_biquad_to_q31(&bq, &c->lp);
+
+	float delay = p->delay_us * sample_rate / 1e6f;
+	delay = fminf(delay, (float)AUDIO_CROSSFEED_MAX_DELAY - 1.0f);
+	c->delay = (uint8_t)delay;
+	c->frac = (uint16_t)((delay - c->delay) * 32768.0f);
+}
+
+void audio_crossfeed_init(uint32_t sample_rate) {
+	fs = (float)sample_rate;
+	preset_cur = AUDIO_CROSSFEED_OFF;
+	audio_crossfeed_calc(&audio_crossfeed_presets[AUDIO_CROSSFEED_CHU_MOY], fs, &coef);
+	lp.coef = coef.lp;
+	params_buf[0] = coef;
+	audio_params_init(&params, &params_buf[0], &params_buf[1], sizeof(AudioCrossfeedCoef));
+	audio_crossfeed_reset();
+}
+
+void audio_crossfeed_set_preset(AudioCrossfeedPreset preset) {
+	if (preset >= AUDIO_CROSSFEED_PRESET_CNT) {
+		return;
+	}
+
+	preset_cur = preset;
+	if (preset != AUDIO_CROSSFEED_OFF) {
+		audio_crossfeed_calc(&audio_crossfeed_presets[preset], fs, audio_params_edit(&params));
+		audio_params_publish(&params);
+	}
+	audio_pipeline_enable(&audio_crossfeed_stage, preset != AUDIO_CROSSFEED_OFF);
+}
+
+void audio_crossfeed_set_sample_rate(uint32_t sample_rate) {
+	fs = (float)sample_rate;
+	// the delay and the low pass depend on the rate, the preset stays
+	const AudioCrossfeedPreset p = (preset_cur != AUDIO_CROSSFEED_OFF) ? preset_cur : AUDIO_CROSSFEED_CHU_MOY;
+	audio_crossfeed_calc(&audio_crossfeed_presets[p], fs, audio_params_edit(&params));
+	audio_params_publish(&params);
+	audio_crossfeed_reset();
+}
+
+void audio_crossfeed_reset(void) {
+	memset(hist, 0, sizeof(hist));
+	memset(lp.st, 0, sizeof(lp.st));
+}
+
+static inline int32_t sat_q31(int64_t s) {
+	if (s > INT32_MAX) {
+		return INT32_MAX;
+	}
+	if (s < INT32_MIN) {
+		return INT32_MIN;
+	}
+	return (int32_t)s;
+}
+
+void audio_crossfeed_process(int32_t *buf, uint16_t n_frames) {
+	bool changed;
+	const AudioCrossfeedCoef *p = audio_params_take(&params, &changed);
+	if (changed) {
+		coef = *p;
+		lp.coef = coef.lp;
+	}
+
+	// the low pass and the delay are both linear, so one low pass of each channel serves
+	// its own direct path (undelayed) and the opposite channel's cross path (delayed)
+	int32_t *lp_cur = &hist[2 * HIST_FRAMES];
+	memcpy(lp_cur, buf, n_frames * 2 * sizeof(int32_t));
+	audio_biquad_stereo(lp_cur, n_frames, &lp);
+
+	// the opposite channel 'delay' and 'delay + 1' frames back, linearly interpolated
+	const int32_t f = coef.frac;
+	const int32_t *p0 = &hist[2 * (HIST_FRAMES - coef.delay)];
+	const int32_t *p1 = p0 - 2;
+	for (uint16_t i = 0; i < n_frames; ++i) {
+		const int32_t r0 = p0[2 * i + 1], r1 = p1[2 * i + 1];
+		const int32_t l0 = p0[2 * i + 0], l1 = p1[2 * i + 0];
+		const int32_t cross_l = r0 + (int32_t)((((int64_t)r1 - r0) * f) >> 15);
+		const int32_t cross_r = l0 + (int32_t)((((int64_t)l1 - l0) * f) >> 15);
+		buf[2 * i + 0] = sat_q31((int64_t)buf[2 * i + 0] - lp_cur[2 * i + 0] + cross_l);
+		buf[2 * i + 1] = sat_q31((int64_t)buf[2 * i + 1] - lp_cur[2 * i + 1] + cross_r);
+	}
+
+	// keep the tail for the next block
+	memmove(hist, &hist[2 * n_frames], HIST_FRAMES * 2 * sizeof(int32_t));
+}
+
+#if CFG_AUDIO_BENCHMARK
+#include "cycle_counter.h"
+#include <stdio.h>
+
+void audio_crossfeed_benchmark(void) {
+	static int32_t buf[2 * AUDIO_PIPELINE_BLOCK_FRAMES];
+
+	for (uint16_t i = 0; i < 2 * AUDIO_PIPELINE_BLOCK_FRAMES; ++i) {
+		buf[i] = (int32_t)((int16_t)(i * 1237)) << 16;
+	}
+
+	cycle_counter_init();
+
+	const uint32_t start = cycle_counter_get();
+	audio_crossfeed_process(buf, AUDIO_PIPELINE_BLOCK_FRAMES);
+	const uint32_t cycles = cycle_counter_get() - start;
+
+	printf("crossfeed: %lu cycles, %lu cycles/sample\n", cycles, cycles / (2 * AUDIO_PIPELINE_BLOCK_FRAMES));
+
+	audio_crossfeed_reset();
+}
+#endif
@@ -0,0 +1,150 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "audio_dither.h"
+#include "audio_common.h"
+#include "custom_math.h"
+
+// the 24bit LSB in Q31
+#define LSB             256
+#define Q24_MASK        (~(int32_t)(LSB - 1))
+// the largest 24bit value in Q31
+#define Q24_MAX         (INT32_MAX & Q24_MASK)
+
+static volatile AudioDitherMode mode;
+static uint32_t prng = 0x9E3779B9;
+static int32_t err[2]; // last quantization error of L and R (noise shaping)
+
+AudioStage audio_dither_stage = {
+	.name = "dither",
+	.process = audio_dither_process,
+	.enable_req = true,
+};
+
+void audio_dither_init(AudioDitherMode m) {
+	mode = m;
+	err[0] = err[1] = 0;
+}
+
+void audio_dither_set_mode(AudioDitherMode m) {
+	mode = m;
+}
+
+static inline uint32_t xorshift32(void) {
+	uint32_t x = prng;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	prng = x;
+	return x;
+}
+
+// rounds to 24bit, saturated
+static inline int32_t quantize(int64_t v) {
+	v = (v + LSB / 2) & Q24_MASK;
+	if (v > Q24_MAX) {
+		return Q24_MAX;
+	}
+	if (v < INT32_MIN) {
+		return INT32_MIN;
+	}
+	return (int32_t)v;
+}
+
+void audio_dither_process(int32_t *buf, uint16_t n_frames) {
+	// already 24bit, e.g. only the limiter (at unity gain) runs, or silence
+	int32_t low_bits = 0;
+	for (uint16_t i = 0; i < 2 * n_frames; ++i) {
+		low_bits |= buf[i];
+	}
+	if ((low_bits & (LSB - 1)) == 0) {
+		return;
+	}
+
+	const AudioDitherMode m = mode;
+
+	if (m == AUDIO_DITHER_OFF) {
+		for (uint16_t i = 0; i < 2 * n_frames; ++i) {
+			buf[i] = quantize(buf[i]);
+		}
+		return;
+	}
+
+	int32_t el = err[0], er = err[1];
+
+	for (uint16_t i = 0; i < n_frames; ++i) {
+		// 2x TPDF in (-LSB, LSB): the difference of two 8bit uniform values each
+		const uint32_t r = xorshift32();
+		const int32_t dl = (int32_t)(r & 0xFF) - (int32_t)((r >> 8) & 0xFF);
+		const int32_t dr = (int32_t)((r >> 16) & 0xFF) - (int32_t)(r >> 24);
+
+		if (m == AUDIO_DITHER_SHAPED) {
+			// error feedback, the total error is shaped by (1 - z^-1)
+			const int64_t vl = (int64_t)buf[2 * i + 0] - el;
+			const int64_t vr = (int64_t)buf[2 * i + 1] - er;
+			const int32_t ql = quantize(vl + dl);
+			const int32_t qr = quantize(vr + dr);
+			// it is never more than a few LSB (except in saturation), limited so it can't run away
+			el = (int32_t)MAX(MIN((int64_t)ql - vl, 4 * LSB), -4 * LSB);
+			er = (int32_t)MAX(MIN((int64_t)qr - vr, 4 * LSB), -4 * LSB);
+			buf[2 * i + 0] = ql;
+			buf[2 * i + 1] = qr;
+		} else {
+			buf[2 * i + 0] = quantize((int64_t)buf[2 * i + 0] + dl);
+			buf[2 * i + 1] = quantize((int64_t)buf[2 * i + 1] + dr);
+		}
+	}
+
+	err[0] = el;
+	err[1] = er;
+}
+
+#if CFG_AUDIO_BENCHMARK
+#include "cycle_counter.h"
+#include <stdio.h>
+
+void audio_dither_benchmark(void) {
+	static int32_t buf[2 * AUDIO_PIPELINE_BLOCK_FRAMES];
+	const AudioDitherMode saved = mode;
+
+	cycle_counter_init();
+
+	for (AudioDitherMode m = AUDIO_DITHER_OFF; m <= AUDIO_DITHER_SHAPED; ++m) {
+		mode = m;
+		for (uint16_t i = 0; i < 2 * AUDIO_PIPELINE_BLOCK_FRAMES; ++i) {
+			buf[i] = (int32_t)(i * 0x01234567u);
+		}
+
+		const uint32_t start = cycle_counter_get();
+		audio_dither_process(buf, AUDIO_PIPELINE_BLOCK_FRAMES);
+		const uint32_t cycles = cycle_counter_get() - start;
+
+		printf("dither mode %u: %lu cycles, %lu cycles/sample\n", m, cycles, cycles / (2 * AUDIO_PIPELINE_BLOCK_FRAMES));
+	}
+
+	audio_dither_init(saved);
+}
+#endif
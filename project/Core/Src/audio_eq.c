@@ -0,0 +1,391 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "audio_eq.h"
+#include "audio_common.h"
+#include "audio_params.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+_Static_assert(CFG_AUDIO_EQ_BANDS >= AUDIO_EQ_PRESET_BANDS, "the presets need more bands");
+
+const AudioEqPresetParams audio_eq_presets[AUDIO_EQ_PRESET_CNT] = {
+	[AUDIO_EQ_FLAT]  = { " Flat", { { 0 } } },
+	[AUDIO_EQ_BASS]  = { "Bass+", {
+		{ true, AUDIO_EQ_HIGH_SHELF,  200.0f, -6.0f, 0.707f },
+	} },
+	[AUDIO_EQ_VOCAL] = { "Vocal", {
+		{ true, AUDIO_EQ_HIGH_PASS,    40.0f,  0.0f, 0.707f },
+		{ true, AUDIO_EQ_LOW_SHELF,   300.0f, -4.0f, 0.707f },
+		{ true, AUDIO_EQ_HIGH_SHELF, 6000.0f, -3.0f, 0.707f },
+	} },
+	[AUDIO_EQ_SMILE] = { "Smile", {
+		{ true, AUDIO_EQ_PEAK,       1000.0f, -6.0f, 0.5f   },
+	} },
+};
+
+static float fs;
+
+// a change which moves the response this much is crossfaded over CFG_AUDIO_EQ_XFADE_BLOCKS,
+// smaller ones just continue with the new coefficients
+#define XFADE_GAIN_DB       3.0f
+#define XFADE_FREQ_RATIO    1.25f   // ~1/3 octave, for the frequency and for the q
+
+typedef struct {
+	AudioBiquadQ31Coef coef[CFG_AUDIO_EQ_BANDS];
+	bool enabled[CFG_AUDIO_EQ_BANDS];
+	// incremented by a publish with a large change. A count and not a flag: it is carried into the next
+	// edit, so a large change is still seen when the refill takes only a later block
+	uint8_t xfade_seq;
+} EqParams;
+
+// written by audio_eq_set_band() / audio_eq_set_preset(), taken over by the refill at the next block
+static EqParams params_buf[2];
+static AudioParams params;
+
+// the last settings of the bands, main loop only
+static AudioEqBand band_cfg[CFG_AUDIO_EQ_BANDS];
+
+// used by the refill
+static AudioBiquadQ31 stage[CFG_AUDIO_EQ_BANDS];
+static uint8_t active_band[CFG_AUDIO_EQ_BANDS];
+static uint8_t active_cnt;
+static bool enabled[CFG_AUDIO_EQ_BANDS];
+static uint8_t xfade_taken;     // the last EqParams.xfade_seq seen
+
+#if CFG_AUDIO_EQ_XFADE_BLOCKS
+// the old filters keep running during the crossfade
+static AudioBiquadQ31 old_stage[CFG_AUDIO_EQ_BANDS];
+static uint8_t old_band[CFG_AUDIO_EQ_BANDS];
+static uint8_t old_cnt;
+static int32_t old_out[2 * AUDIO_PIPELINE_BLOCK_FRAMES];
+static uint32_t fade_pos;   // frames since the start of the crossfade, 0 - no crossfade
+#endif
+
+AudioStage audio_eq_stage = {
+	.name = "eq",
+	.process = audio_eq_process,
+	.active = audio_eq_active,
+	.reset = audio_eq_reset,
+	.set_sample_rate = audio_eq_set_sample_rate,
+	.enable_req = true,
+};
+
+void audio_eq_calc_biquad(const AudioEqBand *band, float sample_rate, AudioBiquad *c) {
+	const float w0 = 2.0f * (float)M_PI * band->freq / sample_rate;
+	const float cw = cosf(w0);
+	const float alpha = sinf(w0) / (2.0f * band->q);
+	const float A = powf(10.0f, band->gain_db / 40.0f);
+	const float sa = 2.0f * sqrtf(A) * alpha;
+
+	float b0, b1, b2, a0, a1, a2;
+
+	switch (band->type) {
+	case AUDIO_EQ_LOW_SHELF:
+		b0 = A * ((A + 1) - (A - 1) * cw + sa);
+		b1 = 2 * A * ((A - 1) - (A + 1) * cw);
+		b2 = A * ((A + 1) - (A - 1) * cw - sa);
+		a0 = (A + 1) + (A - 1) * cw + sa;
+		a1 = -2 * ((A - 1) + (A + 1) * cw);
+		a2 = (A + 1) + (A - 1) * cw - sa;
+		break;
+
+	case AUDIO_EQ_HIGH_SHELF:
+		b0 = A * ((A + 1) + (A - 1) * cw + sa);
+		b1 = -2 * A * ((A - 1) + (A + 1) * cw);
+		b2 = A * ((A + 1) + (A - 1) * cw - sa);
+		a0 = (A + 1) - (A - 1) * cw + sa;
+		a1 = 2 * ((A - 1) - (A + 1) * cw);
+		a2 = (A + 1) - (A - 1) * cw - sa;
+		break;
+
+	case AUDIO_EQ_HIGH_PASS:
+		b0 = (1 + cw) / 2;
+		b1 = -(1 + cw);
+		b2 = (1 + cw) / 2;
+		a0 = 1 + alpha;
+		a1 = -2 * cw;
+		a2 = 1 - alpha;
+		break;
+
+	case AUDIO_EQ_LOW_PASS:
+		b0 = (1 - cw) / 2;
+		b1 = 1 - cw;
+		b2 = (1 - cw) / 2;
+		a0 = 1 + alpha;
+		a1 = -2 * cw;
+		a2 = 1 - alpha;
+		break;
+
+	case AUDIO_EQ_PEAK:
+	default:
+		b0 = 1 + alpha * A;
+		b1 = -2 * cw;
+		b2 = 1 - alpha * A;
+		a0 = 1 + alpha / A;
+		a1 = -2 * cw;
+		a2 = 1 - alpha / A;
+		break;
+	}
+
+	c->b0 = b0 / a0;
+	c->b1 = b1 / a0;
+	c->b2 = b2 / a0;
+	c->a1 = a1 / a0;
+	c->a2 = a2 / a0;
+}
+
+void audio_eq_init(uint32_t sample_rate) {
+	fs = (float)sample_rate;
+	memset(stage, 0, sizeof(stage));
+	memset(enabled, 0, sizeof(enabled));
+	memset(band_cfg, 0, sizeof(band_cfg));
+	memset(&params_buf[0], 0, sizeof(params_buf[0]));
+	audio_params_init(&params, &params_buf[0], &params_buf[1], sizeof(EqParams));
+	active_cnt = 0;
+	xfade_taken = 0;
+#if CFG_AUDIO_EQ_XFADE_BLOCKS
+	fade_pos = 0;
+#endif
+}
+
+static bool ratio_over(float a, float b, float limit) {
+	return (a > b * limit) || (b > a * limit);
+}
+
+// when the response changes this much, switching the coefficients in the middle of the signal could click
+static bool large_change(const AudioEqBand *old, const AudioEqBand *cfg) {
+	if (old->enabled != cfg->enabled) {
+		return true;
+	}
+	if (!cfg->enabled) {
+		return false;
+	}
+	return (old->type != cfg->type) || (fabsf(old->gain_db - cfg->gain_db) >= XFADE_GAIN_DB)
+			|| ratio_over(old->freq, cfg->freq, XFADE_FREQ_RATIO) || ratio_over(old->q, cfg->q, XFADE_FREQ_RATIO);
+}
+
+// designs the band into the edited copy, returns true if the change needs a crossfade
+static bool edit_band(EqParams *p, uint8_t band, const AudioEqBand *cfg) {
+	// a band which is off is not designed, its settings may be all zero
+	if (cfg->enabled) {
+		AudioBiquad c;
+		audio_eq_calc_biquad(cfg, fs, &c);
+		audio_biquad_to_q31(&c, &p->coef[band]);
+	}
+	p->enabled[band] = cfg->enabled;
+
+	const bool xfade = large_change(&band_cfg[band], cfg);
+	band_cfg[band] = *cfg;
+	return xfade;
+}
+
+void audio_eq_set_band(uint8_t band, const AudioEqBand *cfg) {
+	if (band >= CFG_AUDIO_EQ_BANDS) {
+		return;
+	}
+
+	EqParams *p = audio_params_edit(&params);
+	if (edit_band(p, band, cfg)) {
+		++p->xfade_seq;
+	}
+	audio_params_publish(&params);
+}
+
+void audio_eq_set_preset(AudioEqPreset preset) {
+	if (preset >= AUDIO_EQ_PRESET_CNT) {
+		return;
+	}
+
+	// all bands in one block, so the refill never runs a half switched preset
+	const AudioEqBand off = { 0 };
+	EqParams *p = audio_params_edit(&params);
+	bool xfade = false;
+	for (uint8_t b = 0; b < CFG_AUDIO_EQ_BANDS; ++b) {
+		xfade |= edit_band(p, b, (b < AUDIO_EQ_PRESET_BANDS) ? &audio_eq_presets[preset].bands[b] : &off);
+	}
+	if (xfade) {
+		++p->xfade_seq;
+	}
+	audio_params_publish(&params);
+}
+
+void audio_eq_set_sample_rate(uint32_t sample_rate) {
+	fs = (float)sample_rate;
+
+	// the same bands designed for the new rate, the stream is stopped, so no crossfade
+	EqParams *p = audio_params_edit(&params);
+	for (uint8_t b = 0; b < CFG_AUDIO_EQ_BANDS; ++b) {
+		if (band_cfg[b].enabled) {
+			AudioBiquad c;
+			audio_eq_calc_biquad(&band_cfg[b], fs, &c);
+			audio_biquad_to_q31(&c, &p->coef[b]);
+		}
+	}
+	audio_params_publish(&params);
+	audio_eq_reset();
+}
+
+bool audio_eq_active(void) {
+#if CFG_AUDIO_EQ_XFADE_BLOCKS
+	// the last band switched off fades out too
+	if (fade_pos != 0) {
+		return true;
+	}
+#endif
+	return (active_cnt != 0) || (params.seq != params.taken);
+}
+
+static void run_bands(int32_t *buf, uint16_t n_frames, AudioBiquadQ31 *stages, const uint8_t *bands, uint8_t cnt) {
+	for (uint8_t i = 0; i < cnt; ++i) {
+		audio_biquad_stereo(buf, n_frames, &stages[bands[i]]);
+	}
+}
+
+// called from the refill, takes over the new coefficients
+static void apply_params(const EqParams *p) {
+	for (uint8_t b = 0; b < CFG_AUDIO_EQ_BANDS; ++b) {
+		// a band which was off starts from a clean state
+		if (p->enabled[b] && !enabled[b]) {
+			memset(stage[b].st, 0, sizeof(stage[b].st));
+		}
+		stage[b].coef = p->coef[b];
+		enabled[b] = p->enabled[b];
+	}
+
+	active_cnt = 0;
+	for (uint8_t b = 0; b < CFG_AUDIO_EQ_BANDS; ++b) {
+		if (enabled[b]) {
+			active_band[active_cnt++] = b;
+		}
+	}
+}
+
+#if CFG_AUDIO_EQ_XFADE_BLOCKS
+#define FADE_FRAMES   (CFG_AUDIO_EQ_XFADE_BLOCKS * AUDIO_PIPELINE_BLOCK_FRAMES)
+
+// from the old filters' output to the new one (in 'buf') with a smoothstep, Q15.
+// A linear fade has a kink at both ends, which is worse than the plain coefficient swap on low frequencies
+static void fade(int32_t *buf, uint16_t n_frames) {
+	for (uint16_t i = 0; i < n_frames; ++i) {
+		int64_t g = 32768;
+		if (fade_pos < FADE_FRAMES) {
+			const int64_t t = ((int64_t)fade_pos << 15) / FADE_FRAMES;
+			g = (t * t * (3 * 32768 - 2 * t)) >> 30;
+			++fade_pos;
+		}
+
+		for (uint8_t ch = 0; ch < 2; ++ch) {
+			const int32_t o = old_out[2 * i + ch];
+			buf[2 * i + ch] = o + (int32_t)((((int64_t)buf[2 * i + ch] - o) * g) >> 15);
+		}
+	}
+
+	if (fade_pos >= FADE_FRAMES) {
+		fade_pos = 0;
+	}
+}
+#endif
+
+void audio_eq_process(int32_t *buf, uint16_t n_frames) {
+	bool changed;
+	const EqParams *p = audio_params_take(&params, &changed);
+
+	if (changed) {
+#if CFG_AUDIO_EQ_XFADE_BLOCKS
+		// the old filters continue from the current state, the new ones too.
+		// A change during a running crossfade only swaps the coefficients of the new side
+		if ((p->xfade_seq != xfade_taken) && (fade_pos == 0) && (n_frames <= AUDIO_PIPELINE_BLOCK_FRAMES)) {
+			memcpy(old_stage, stage, sizeof(stage));
+			memcpy(old_band, active_band, sizeof(active_band));
+			old_cnt = active_cnt;
+			fade_pos = 1;
+		}
+#endif
+		xfade_taken = p->xfade_seq;
+		apply_params(p);
+	}
+
+#if CFG_AUDIO_EQ_XFADE_BLOCKS
+	if (fade_pos != 0) {
+		memcpy(old_out, buf, n_frames * 2 * sizeof(int32_t));
+		run_bands(old_out, n_frames, old_stage, old_band, old_cnt);
+		run_bands(buf, n_frames, stage, active_band, active_cnt);
+		fade(buf, n_frames);
+		return;
+	}
+#endif
+
+	run_bands(buf, n_frames, stage, active_band, active_cnt);
+}
+
+void audio_eq_reset(void) {
+	for (uint8_t b = 0; b < CFG_AUDIO_EQ_BANDS; ++b) {
+		memset(stage[b].st, 0, sizeof(stage[b].st));
+	}
+}
+
+#if CFG_AUDIO_BENCHMARK
+#include "cycle_counter.h"
+#include "main.h" // AUDIO_SAMPLING_RATE
+#include <stdio.h>
+
+// 1ms of stereo audio
+#define BENCH_FRAMES 48
+#define BENCH_BANDS  10
+
+void audio_eq_benchmark(void) {
+	static int32_t buf[2 * BENCH_FRAMES];
+	static AudioBiquadQ31 st[BENCH_BANDS];
+	static const uint8_t bands[] = { 5, 8, 10 };
+
+	const AudioEqBand peak = { .enabled = true, .type = AUDIO_EQ_PEAK, .freq = 1000.0f, .gain_db = 3.0f, .q = 1.0f };
+	for (uint8_t b = 0; b < BENCH_BANDS; ++b) {
+		AudioBiquad c;
+		audio_eq_calc_biquad(&peak, AUDIO_SAMPLING_RATE, &c);
+		audio_biquad_to_q31(&c, &st[b].coef);
+	}
+	for (uint16_t i = 0; i < 2 * BENCH_FRAMES; ++i) {
+		buf[i] = (int32_t)((int16_t)(i * 1237)) << 16;
+	}
+
+	cycle_counter_init();
+
+	for (uint8_t n = 0; n < sizeof(bands); ++n) {
+		const uint32_t start = cycle_counter_get();
+		for (uint8_t b = 0; b < bands[n]; ++b) {
+			audio_biquad_stereo(buf, BENCH_FRAMES, &st[b]);
+		}
+		const uint32_t cycles = cycle_counter_get() - start;
+
+		printf("eq %u bands: %lu cycles, %lu cycles/sample\n", bands[n], cycles, cycles / (2 * BENCH_FRAMES));
+	}
+}
+#endif
@@ -0,0 +1,120 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "audio_feedback.h"
+#include "custom_math.h"
+
+// the rate and the FIFO level are averaged over (at least) 2^FB_BLOCK_SHIFT SOFs (64ms)
+// so the resolution of the measured rate is 1/64 frame
+#define FB_BLOCK_SHIFT     6
+#define FB_BLOCK_LEN       (1 << FB_BLOCK_SHIFT)
+
+// the rate estimate is smoothed by a 1/4 IIR over the blocks
+#define FB_RATE_SHIFT      2
+
+// PI gains in 16.16 per frame of FIFO error
+//  - P: 48 frames (1ms) off gives ~0.05 frame/SOF correction
+//  - I: accumulates per block, removes the residual offset
+#define FB_KP              64
+#define FB_KI              4
+
+// feedback is limited to nominal +-0.25 frame/SOF (~5000ppm at 48kHz), which is far more
+// than any real clock drift. When the output is limited the integrator is frozen (anti-windup)
+#define FB_MAX_DEV         (1 << 14)
+#define FB_INTEG_MAX       (1 << 13)
+
+AudioFeedbackState audio_feedback_state;
+
+static uint16_t target_frames;
+static uint32_t played_sum;
+static uint32_t sof_sum;
+static uint32_t fifo_sum;
+static uint8_t block_cnt;
+
+void audio_feedback_init(uint32_t sample_rate, uint16_t fifo_target_frames) {
+	audio_feedback_state.nominal = ((sample_rate / 100) << 16) / 10; // frames per 1ms SOF
+	audio_feedback_state.rate = audio_feedback_state.nominal;
+	audio_feedback_state.value = audio_feedback_state.nominal;
+	audio_feedback_state.integ = 0;
+	audio_feedback_state.fifo_err = 0;
+
+	target_frames = fifo_target_frames;
+	played_sum = 0;
+	sof_sum = 0;
+	fifo_sum = 0;
+	block_cnt = 0;
+}
+
+uint32_t audio_feedback_update(uint16_t played_frames, uint16_t sof_frames, uint16_t fifo_frames, bool regulate) {
+	AudioFeedbackState *st = &audio_feedback_state;
+
+	played_sum += played_frames;
+	sof_sum += sof_frames;
+	fifo_sum += fifo_frames;
+	++block_cnt;
+	if (sof_sum < FB_BLOCK_LEN) {
+		return st->value;
+	}
+
+	// the played frames per SOF, a late update covers more SOFs and is not lost
+	// the I2S is not running (yet), there is nothing to measure
+	const uint32_t measured = (played_sum && sof_sum) ?
+			(uint32_t)(((uint64_t)played_sum << 16) / sof_sum) : st->nominal;
+	st->rate = (uint32_t)((int32_t)st->rate + (((int32_t)measured - (int32_t)st->rate) >> FB_RATE_SHIFT));
+
+	int32_t out = (int32_t)st->rate;
+
+	if (regulate) {
+		// FIFO is below the target -> ask for more
+		st->fifo_err = (int32_t)target_frames - (int32_t)(fifo_sum / block_cnt);
+
+		int32_t integ = st->integ + st->fifo_err * FB_KI;
+		integ = MIN(integ, FB_INTEG_MAX);
+		integ = MAX(integ, -FB_INTEG_MAX);
+
+		out += st->fifo_err * FB_KP + integ;
+
+		const int32_t hi = (int32_t)st->nominal + FB_MAX_DEV;
+		const int32_t lo = (int32_t)st->nominal - FB_MAX_DEV;
+		if ((out > hi) || (out < lo)) {
+			out = MIN(out, hi);
+			out = MAX(out, lo);
+			++st->saturated;
+		} else {
+			st->integ = integ;
+		}
+	}
+
+	st->value = (uint32_t)out;
+
+	played_sum = 0;
+	sof_sum = 0;
+	fifo_sum = 0;
+	block_cnt = 0;
+
+	return st->value;
+}
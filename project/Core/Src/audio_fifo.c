@@ -0,0 +1,106 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "audio_fifo.h"
+#include "audio_salvage.h"
+#include "custom_math.h"
+#include <string.h>
+
+uint16_t audio_fifo_read_to_i2s(tu_fifo_t *ff, uint8_t *dst, uint16_t n_samples,
+		uint8_t sample_bytes, AudioUnpackFunc unpack) {
+	tu_fifo_buffer_info_t info;
+	tu_fifo_get_read_info(ff, &info);
+
+	// only whole stereo frames, so a short read can't swap the L/R channels
+	uint16_t avail = (info.linear.len + info.wrapped.len) / (2 * sample_bytes) * 2;
+	n_samples = MIN(n_samples, avail);
+
+	uint16_t n_lin = MIN(n_samples, info.linear.len / sample_bytes);
+	unpack(dst, info.linear.ptr, n_lin);
+
+	uint16_t done = n_lin;
+	uint16_t wrp_offs = 0;
+
+	// the sample which is split by the wrap around
+	const uint8_t split = info.linear.len % sample_bytes;
+	if ((done < n_samples) && (split != 0)) {
+		uint8_t sample[4];
+		memcpy(sample, &info.linear.ptr[n_lin * sample_bytes], split);
+		memcpy(&sample[split], info.wrapped.ptr, sample_bytes - split);
+		unpack(&dst[done * 4], sample, 1);
+
+		++done;
+		wrp_offs = sample_bytes - split;
+	}
+
+	if (done < n_samples) {
+		unpack(&dst[done * 4], &info.wrapped.ptr[wrp_offs], n_samples - done);
+	}
+
+	tu_fifo_advance_read_pointer(ff, n_samples * sample_bytes);
+	return n_samples;
+}
+
+void audio_fifo_realign_packet(tu_fifo_t *ff, uint16_t n_received, uint8_t sample_bytes) {
+	const uint16_t frame = 2 * sample_bytes;
+	const uint16_t misalign = n_received % frame;
+	if (misalign == 0) {
+		return;
+	}
+
+	if (sample_bytes != 3) {
+		// the salvage is for 24bit samples, otherwise only the incomplete frame at the end is dropped
+		tu_fifo_advance_write_pointer(ff, (uint16_t)(2 * ff->depth - misalign));
+		return;
+	}
+
+	// Rolling BACK the write pointer by 'n_received' (deleting the whole packet) is a 1ms gap.
+	// Just deleting the last 'misalign' bytes is not enough, it is audible, because the bytes
+	// are not always missing at the end. So take the packet back out of the FIFO,
+	// find where it got shifted, realign the rest and put it back (see audio_salvage.c)
+	static uint8_t packet[6 + CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS];
+	static uint8_t salvaged[CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS + 6];
+	const uint16_t n = MIN(n_received, CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS);
+
+	// take the packet back together with the frame before it (if it is not played yet),
+	// the packet is still there in the (now) free part of the FIFO
+	const uint16_t prev = (tu_fifo_count(ff) >= n + frame) ? frame : 0;
+	tu_fifo_advance_write_pointer(ff, (uint16_t)(2 * ff->depth - n - prev));
+
+	tu_fifo_buffer_info_t info;
+	tu_fifo_get_write_info(ff, &info);
+	const uint16_t n_lin = MIN(n + prev, info.linear.len);
+	memcpy(packet, info.linear.ptr, n_lin);
+	memcpy(&packet[n_lin], info.wrapped.ptr, n + prev - n_lin);
+
+	// the previous frame stays as it was
+	tu_fifo_advance_write_pointer(ff, prev);
+
+	uint16_t len = audio_salvage_packet(salvaged, &packet[prev], n, prev ? packet : NULL);
+	// whole frames only, so an overwrite of the oldest data keeps the alignment
+	len = MIN(len, tu_fifo_remaining(ff) / frame * frame);
+	tu_fifo_write_n(ff, salvaged, len);
+}
@@ -0,0 +1,302 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "audio_limiter.h"
+#include "audio_common.h"
+#include "CS43L22_driver.h"
+#include "stm32f4xx_hal.h"
+#include "custom_math.h"
+#include <math.h>
+#include <string.h>
+
+// gains are Q24, so a sum of AUDIO_LIMITER_MAX_LOOKAHEAD of them fits in 32bit
+#define GAIN_ONE            (1u << 24)
+
+// The lowest required gain is held for (at least) the look-ahead + 1 frames (the detector is 1 frame late).
+// It is the min of the current sub-block and of the last hold_subblocks complete ones,
+// so it costs only a compare per frame (exact sliding min would need a deque).
+#define SUBBLOCK_FRAMES     8
+#define MAX_HOLD_SUBBLOCKS  (AUDIO_LIMITER_MAX_LOOKAHEAD / SUBBLOCK_FRAMES + 1)
+
+// then release: gain += (1 - gain) / 2^release_shift per frame
+
+// the interpolated peak is not exact, keep some margin below the ceiling
+#define TRUE_PEAK_MARGIN_DB_X10   3
+
+// how often the codec overflow flags are read (I2C)
+#define CLIP_POLL_MS        100
+
+// a register read is ~0.4ms at 100kHz, a busy or stuck bus must not block the main loop for long
+#define CLIP_READ_TIMEOUT_MS    2
+
+_Static_assert((AUDIO_LIMITER_MAX_LOOKAHEAD & (AUDIO_LIMITER_MAX_LOOKAHEAD - 1)) == 0, "look-ahead has to be a power of 2");
+_Static_assert((uint64_t)AUDIO_LIMITER_MAX_LOOKAHEAD * GAIN_ONE <= UINT32_MAX, "the look-ahead sum has to fit in 32bit");
+
+AudioLimiterStats audio_limiter_stats;
+
+static volatile float ceiling;   // linear, of the Q31 full scale
+
+// for the sample rate, the output delay is the look-ahead + 1 frames (see the detector in audio_limiter_process())
+static uint8_t lookahead_shift;
+static uint16_t lookahead;
+static uint16_t delay_frames;
+static uint8_t hold_subblocks;
+static uint8_t release_shift;
+
+// the delayed input, ring of delay_frames stereo frames
+static int32_t delay_line[2 * (AUDIO_LIMITER_MAX_LOOKAHEAD + 1)];
+static uint16_t delay_pos;
+
+// the last 3 input frames for the true peak detector
+static int32_t tap[3][2];
+
+// min of the required gain over the hold time
+static uint32_t sub_min[MAX_HOLD_SUBBLOCKS];
+static uint32_t cur_min;     // of the current sub-block
+static uint32_t hold_min;    // of the complete ones
+static uint8_t sub_pos;
+static uint8_t sub_frames;
+
+// hold/release envelope and its moving average over the look-ahead
+static uint32_t env;
+static uint32_t avg_ring[AUDIO_LIMITER_MAX_LOOKAHEAD];
+static uint32_t avg_sum;
+static uint8_t avg_pos;
+
+// the lowest output gain, for the meter
+static volatile uint32_t min_gain;
+
+static void limiter_reset(void);
+
+AudioStage audio_limiter_stage = {
+	.name = "limiter",
+	.process = audio_limiter_process,
+	.reset = limiter_reset,
+	.set_sample_rate = audio_limiter_set_sample_rate,
+	.enable_req = true,
+};
+
+static void limiter_reset(void) {
+	memset(delay_line, 0, sizeof(delay_line));
+	memset(tap, 0, sizeof(tap));
+	delay_pos = 0;
+	for (uint8_t i = 0; i < MAX_HOLD_SUBBLOCKS; ++i) {
+		sub_min[i] = GAIN_ONE;
+	}
+	cur_min = GAIN_ONE;
+	hold_min = GAIN_ONE;
+	sub_pos = 0;
+	sub_frames = 0;
+	env = GAIN_ONE;
+	for (uint8_t i = 0; i < AUDIO_LIMITER_MAX_LOOKAHEAD; ++i) {
+		avg_ring[i] = GAIN_ONE;
+	}
+	avg_sum = lookahead * GAIN_ONE;
+	avg_pos = 0;
+}
+
+// log2 of the power of 2 frames closest to 'us' at the rate
+static uint8_t frames_log2(uint32_t sample_rate, uint32_t us) {
+	const uint32_t frames = (uint32_t)((uint64_t)sample_rate * us / 1000000);
+	uint8_t shift = 0;
+	// the next power is closer from 1.5x on
+	while (2 * frames >= (3u << shift)) {
+		++shift;
+	}
+	return shift;
+}
+
+void audio_limiter_set_sample_rate(uint32_t sample_rate) {
+	lookahead_shift = frames_log2(sample_rate, AUDIO_LIMITER_LOOKAHEAD_US);
+	while ((1u << lookahead_shift) > AUDIO_LIMITER_MAX_LOOKAHEAD) {
+		--lookahead_shift;
+	}
+	lookahead = 1u << lookahead_shift;
+	delay_frames = lookahead + 1;
+	hold_subblocks = lookahead / SUBBLOCK_FRAMES + 1;
+	release_shift = frames_log2(sample_rate, AUDIO_LIMITER_RELEASE_US);
+
+	// the stream is stopped, the next one starts clean
+	limiter_reset();
+}
+
+void audio_limiter_init(uint32_t sample_rate) {
+	audio_limiter_set_sample_rate(sample_rate);
+	min_gain = GAIN_ONE;
+	audio_limiter_set_ceiling_db_x10(0);
+}
+
+void audio_limiter_set_ceiling_db_x10(int16_t ceiling_db) {
+	ceiling_db = MIN(ceiling_db, 0) - TRUE_PEAK_MARGIN_DB_X10;
+	ceiling = powf(10.0f, (float)ceiling_db / 200.0f) * 2147483648.0f;
+}
+
+int16_t audio_limiter_get_reduction_db_x10(void) {
+	// the refill may lower it between the read and the clear
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	const uint32_t g = min_gain;
+	min_gain = GAIN_ONE;
+	__set_PRIMASK(primask);
+
+	if (g >= GAIN_ONE) {
+		return 0;
+	}
+	return (int16_t)(-200.0f * log10f((float)MAX(g, 1u) / GAIN_ONE));
+}
+
+void audio_limiter_task(void) {
+	static uint32_t last_ms = 0;
+	const uint32_t curr_ms = HAL_GetTick();
+
+	if ((curr_ms - last_ms < CLIP_POLL_MS) || (get_audio_state() != I2S_AUDIO_STREAMING)) {
+		return;
+	}
+	last_ms = curr_ms;
+
+	uint8_t clip = 0;
+	if ((CS43L22_read_clip_reg(&clip, CLIP_READ_TIMEOUT_MS) == 0) && clip) {
+		++audio_limiter_stats.codec_clips;
+	}
+}
+
+static inline uint32_t abs_q31(int64_t v) {
+	return (uint32_t)((v < 0) ? -v : v);
+}
+
+void audio_limiter_process(int32_t *buf, uint16_t n_frames) {
+	const float c = ceiling;
+	uint32_t block_min = GAIN_ONE;
+
+	for (uint16_t i = 0; i < n_frames; ++i) {
+		// Peak of the previous frame and of the half sample point before it
+		// (4 tap interpolation: -1/16, 9/16, 9/16, -1/16), so it is 1 frame late
+		uint32_t peak = 0;
+		for (uint8_t ch = 0; ch < 2; ++ch) {
+			const int32_t x = buf[2 * i + ch];
+			const int64_t mid = (9 * ((int64_t)tap[1][ch] + tap[2][ch]) - tap[0][ch] - x) >> 4;
+			peak = MAX(peak, abs_q31(tap[2][ch]));
+			peak = MAX(peak, abs_q31(mid));
+
+			tap[0][ch] = tap[1][ch];
+			tap[1][ch] = tap[2][ch];
+			tap[2][ch] = x;
+		}
+
+		// the required gain, held
+		uint32_t need = GAIN_ONE;
+		if ((float)peak > c) {
+			need = (uint32_t)(c / (float)peak * (float)GAIN_ONE);
+		}
+		cur_min = MIN(cur_min, need);
+		const uint32_t held = MIN(cur_min, hold_min);
+
+		if (++sub_frames >= SUBBLOCK_FRAMES) {
+			sub_frames = 0;
+			sub_min[sub_pos] = cur_min;
+			if (++sub_pos >= hold_subblocks) {
+				sub_pos = 0;
+			}
+			cur_min = GAIN_ONE;
+			hold_min = GAIN_ONE;
+			for (uint8_t s = 0; s < hold_subblocks; ++s) {
+				hold_min = MIN(hold_min, sub_min[s]);
+			}
+		}
+
+		// instant attack, exponential release
+		if (held <= env) {
+			env = held;
+		} else {
+			env += (GAIN_ONE - env) >> release_shift;
+			env = MIN(env, held);
+		}
+
+		// The moving average of the envelope is below the required gain for the whole look-ahead
+		// before the peak, so it ramps down smoothly and reaches it when the peak is at the output
+		avg_sum += env - avg_ring[avg_pos];
+		avg_ring[avg_pos] = env;
+		avg_pos = (avg_pos + 1) & (lookahead - 1);
+		const uint32_t g = avg_sum >> lookahead_shift;
+		block_min = MIN(block_min, g);
+
+		// output the delayed frame, the current one goes in its place
+		int32_t *d = &delay_line[2 * delay_pos];
+		const int32_t out_l = d[0], out_r = d[1];
+		d[0] = buf[2 * i + 0];
+		d[1] = buf[2 * i + 1];
+		if (++delay_pos >= delay_frames) {
+			delay_pos = 0;
+		}
+
+		if (g < GAIN_ONE) {
+			buf[2 * i + 0] = (int32_t)(((int64_t)out_l * g) >> 24);
+			buf[2 * i + 1] = (int32_t)(((int64_t)out_r * g) >> 24);
+		} else {
+			buf[2 * i + 0] = out_l;
+			buf[2 * i + 1] = out_r;
+		}
+	}
+
+	if (block_min < GAIN_ONE) {
+		++audio_limiter_stats.limited_blocks;
+		if (block_min < min_gain) {
+			min_gain = block_min;
+		}
+	}
+}
+
+#if CFG_AUDIO_BENCHMARK
+#include "cycle_counter.h"
+#include <stdio.h>
+
+void audio_limiter_benchmark(void) {
+	static int32_t buf[2 * AUDIO_PIPELINE_BLOCK_FRAMES];
+	static const int16_t ceilings[] = { 0, -120 };
+	const float ceiling_set = ceiling;
+
+	cycle_counter_init();
+
+	for (uint8_t n = 0; n < sizeof(ceilings) / sizeof(ceilings[0]); ++n) {
+		audio_limiter_set_ceiling_db_x10(ceilings[n]);
+		for (uint16_t i = 0; i < 2 * AUDIO_PIPELINE_BLOCK_FRAMES; ++i) {
+			buf[i] = (int32_t)((int16_t)(i * 1237)) << 16;
+		}
+
+		const uint32_t start = cycle_counter_get();
+		audio_limiter_process(buf, AUDIO_PIPELINE_BLOCK_FRAMES);
+		const uint32_t cycles = cycle_counter_get() - start;
+
+		printf("limiter ceiling %d dB/10: %lu cycles, %lu cycles/sample\n", ceilings[n], cycles,
+				cycles / (2 * AUDIO_PIPELINE_BLOCK_FRAMES));
+	}
+
+	// the benchmark signal must not get to the output, the ceiling stays the one set before
+	limiter_reset();
+	min_gain = GAIN_ONE;
+	ceiling = ceiling_set;
+}
+#endif
@@ -0,0 +1,158 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "audio_loudness.h"
+#include "audio_biquad.h"
+#include "loudness_table.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// the makeup gain is Q27, up to +24dB
+#define MAKEUP_SHIFT    27
+#define MAKEUP_UNITY    (1 << MAKEUP_SHIFT)
+
+// 1-pole smoothing like in audio_volume.c, so the makeup follows the digital volume which makes the room for it
+#define SMOOTH_SHIFT    7
+
+static bool available;
+static bool requested;   // the UI switch
+static bool enabled;
+static uint16_t vol_index;
+
+// used by the refill
+static AudioBiquadQ31 stages[2];
+static uint16_t active_index;
+
+static int32_t makeup_gain;
+
+// the table index and its makeup gain the refill has to take over, written by the main loop
+static volatile uint16_t pending_index;
+static volatile int32_t makeup_target;
+
+AudioStage audio_loudness_stage = {
+	.name = "loudness",
+	.process = audio_loudness_process,
+	.reset = audio_loudness_reset,
+	.set_sample_rate = audio_loudness_set_sample_rate,
+	.enable_req = false,
+};
+
+static void load(uint16_t i) {
+	stages[0].coef = loudness_table[i].low;
+	stages[1].coef = loudness_table[i].high;
+	active_index = i;
+}
+
+static uint16_t volume_index(int16_t volume) {
+	int32_t i = -volume / LOUDNESS_STEP_DB_X10;
+	if (i < 0) {
+		i = 0;
+	}
+	if (i >= LOUDNESS_TABLE_LEN) {
+		i = LOUDNESS_TABLE_LEN - 1;
+	}
+	return (uint16_t)i;
+}
+
+bool audio_loudness_init(uint32_t sample_rate) {
+	requested = false;
+	vol_index = 0;
+	pending_index = 0;
+	makeup_target = MAKEUP_UNITY;
+	memset(stages, 0, sizeof(stages));
+	load(0);
+	audio_loudness_reset();
+	audio_loudness_set_sample_rate(sample_rate);
+	return available;
+}
+
+void audio_loudness_set_sample_rate(uint32_t sample_rate) {
+	available = (sample_rate == LOUDNESS_TABLE_FS);
+	if (!available) {
+		printf("loudness: the table is for %uHz, not for %luHz\n", LOUDNESS_TABLE_FS, sample_rate);
+	}
+	audio_loudness_enable(requested);
+}
+
+void audio_loudness_enable(bool enable) {
+	requested = enable;
+	enabled = enable && available;
+	audio_pipeline_enable(&audio_loudness_stage, enabled);
+}
+
+void audio_loudness_set_volume_db_x10(int16_t volume) {
+	vol_index = volume_index(volume);
+	// the refill may take the index before the gain, it is one 0.5dB step of the filters for one block at most
+	makeup_target = (int32_t)(powf(10.0f, (float)loudness_table[vol_index].makeup_db_x10 / 200.0f) * MAKEUP_UNITY);
+	pending_index = vol_index;
+}
+
+int16_t audio_loudness_get_makeup_db_x10(int16_t volume) {
+	return enabled ? loudness_table[volume_index(volume)].makeup_db_x10 : 0;
+}
+
+void audio_loudness_reset(void) {
+	for (uint8_t i = 0; i < 2; ++i) {
+		memset(stages[i].st, 0, sizeof(stages[i].st));
+	}
+	makeup_gain = MAKEUP_UNITY;
+}
+
+static inline int32_t apply_makeup(int32_t x, int32_t g) {
+	// the headroom is left by the digital volume, the saturation is only for its smoothing lag
+	const int64_t y = ((int64_t)x * g) >> MAKEUP_SHIFT;
+	if (y > INT32_MAX) {
+		return INT32_MAX;
+	}
+	if (y < INT32_MIN) {
+		return INT32_MIN;
+	}
+	return (int32_t)y;
+}
+
+void audio_loudness_process(int32_t *buf, uint16_t n_frames) {
+	const uint16_t i = pending_index;
+	if (i != active_index) {
+		// the neighbouring steps are close, the filter states are kept
+		load(i);
+	}
+
+	audio_biquad_cascade(buf, n_frames, stages, 2);
+
+	const int32_t t = makeup_target;
+	int32_t g = makeup_gain;
+	for (uint16_t n = 0; n < n_frames; ++n) {
+		if (g != t) {
+			const int32_t step = (t - g) >> SMOOTH_SHIFT;
+			// the last few LSBs would never be reached by the shift
+			g = (step == 0) ? t : g + step;
+		}
+		buf[2 * n + 0] = apply_makeup(buf[2 * n + 0], g);
+		buf[2 * n + 1] = apply_makeup(buf[2 * n + 1], g);
+	}
+	makeup_gain = g;
+}
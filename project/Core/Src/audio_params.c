@@ -0,0 +1,71 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "audio_params.h"
+#include <string.h>
+
+void audio_params_init(AudioParams *p, void *a, void *b, uint16_t size) {
+	p->copy[0] = a;
+	p->copy[1] = b;
+	p->size = size;
+	memcpy(b, a, size);
+	p->front = 0;
+	p->seq = 0;
+	p->taken = 0;
+	p->editing = false;
+}
+
+void* audio_params_edit(AudioParams *p) {
+	uint8_t *back = p->copy[p->front ^ 1];
+
+	// several edits before a publish go to the same copy
+	if (!p->editing) {
+		memcpy(back, p->copy[p->front], p->size);
+		p->editing = true;
+	}
+	return back;
+}
+
+void audio_params_publish(AudioParams *p) {
+	if (!p->editing) {
+		return;
+	}
+	p->editing = false;
+
+	// the copy has to be complete in the memory before the refill can see the new index
+	__atomic_store_n(&p->front, p->front ^ 1, __ATOMIC_RELEASE);
+	__atomic_store_n(&p->seq, p->seq + 1, __ATOMIC_RELEASE);
+}
+
+const void* audio_params_take(AudioParams *p, bool *changed) {
+	const uint8_t seq = __atomic_load_n(&p->seq, __ATOMIC_ACQUIRE);
+	const uint8_t front = __atomic_load_n(&p->front, __ATOMIC_ACQUIRE);
+
+	*changed = (seq != p->taken);
+	p->taken = seq;
+	return p->copy[front];
+}
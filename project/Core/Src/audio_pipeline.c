@@ -0,0 +1,191 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "audio_pipeline.h"
+#include "audio_unpack.h"
+#include "cycle_counter.h"
+#include <stdio.h>
+#include <string.h>
+
+static void decode(int32_t *buf, uint16_t n_frames) {
+	for (uint16_t i = 0; i < 2 * n_frames; ++i) {
+		buf[i] = i2s_frame_to_q31((uint32_t)buf[i]);
+	}
+}
+
+static void pack(int32_t *buf, uint16_t n_frames) {
+	for (uint16_t i = 0; i < 2 * n_frames; ++i) {
+		buf[i] = (int32_t)q31_to_i2s_frame(buf[i]);
+	}
+}
+
+// the first and the last stage, they can't be bypassed
+static AudioStage decode_stage = { .name = "decode", .process = decode, .enable_req = true, .enabled = true };
+static AudioStage pack_stage = { .name = "pack", .process = pack, .enable_req = true, .enabled = true };
+
+// the user stages, between the decode and the pack
+static AudioStage *stages[AUDIO_PIPELINE_MAX_STAGES];
+static uint8_t stage_cnt;
+
+// the input of a stage which is being switched, for the crossfade
+static int32_t dry[2 * AUDIO_PIPELINE_BLOCK_FRAMES];
+
+void audio_pipeline_init(void) {
+	stage_cnt = 0;
+}
+
+bool audio_pipeline_add(AudioStage *stage) {
+	if (stage_cnt >= AUDIO_PIPELINE_MAX_STAGES) {
+		printf("pipeline: no room for %s\n", stage->name);
+		return false;
+	}
+
+	stage->enabled = stage->enable_req;
+	stage->idle = true;
+	stage->cycles = 0;
+	stage->cycles_max = 0;
+	stages[stage_cnt++] = stage;
+	return true;
+}
+
+void audio_pipeline_enable(AudioStage *stage, bool enable) {
+	stage->enable_req = enable;
+}
+
+void audio_pipeline_set_sample_rate(uint32_t sample_rate) {
+	for (uint8_t i = 0; i < stage_cnt; ++i) {
+		if (stages[i]->set_sample_rate != NULL) {
+			stages[i]->set_sample_rate(sample_rate);
+		}
+	}
+}
+
+void audio_pipeline_reset(void) {
+	for (uint8_t i = 0; i < stage_cnt; ++i) {
+		if (stages[i]->reset != NULL) {
+			stages[i]->reset();
+		}
+	}
+}
+
+static inline bool stage_active(const AudioStage *s) {
+	return (s->enabled || s->enable_req) && ((s->active == NULL) || s->active());
+}
+
+bool audio_pipeline_active(void) {
+	for (uint8_t i = 0; i < stage_cnt; ++i) {
+		if (stage_active(stages[i])) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// fades from the dry to the processed signal (or back) over the block
+static void crossfade(int32_t *buf, const int32_t *from_dry, uint16_t n_frames, bool to_wet) {
+	for (uint16_t i = 0; i < n_frames; ++i) {
+		// Q15, reaches the full target on the last frame
+		int32_t g = (int32_t)(((i + 1) << 15) / n_frames);
+		if (!to_wet) {
+			g = 32768 - g;
+		}
+
+		for (uint8_t ch = 0; ch < 2; ++ch) {
+			const int32_t d = from_dry[2 * i + ch];
+			const int64_t diff = (int64_t)buf[2 * i + ch] - d;
+			buf[2 * i + ch] = d + (int32_t)((diff * g) >> 15);
+		}
+	}
+}
+
+static void run_stage(AudioStage *s, int32_t *buf, uint16_t n_frames) {
+	const bool enable = s->enable_req;
+
+	if (!enable && !s->enabled) {
+		s->idle = true;
+		return;
+	}
+
+	if ((s->active != NULL) && !s->active()) {
+		// it would not change the signal anyway, no need to fade
+		s->enabled = enable;
+		s->idle = true;
+		return;
+	}
+
+	const uint32_t start = cycle_counter_get();
+
+	// the filter states (delay lines) are from before the skipped blocks, the signal has moved on since
+	if (s->idle && (s->reset != NULL)) {
+		s->reset();
+	}
+	s->idle = false;
+
+	if (enable != s->enabled) {
+		memcpy(dry, buf, n_frames * 2 * sizeof(int32_t));
+		s->process(buf, n_frames);
+		crossfade(buf, dry, n_frames, enable);
+		s->enabled = enable;
+	} else {
+		s->process(buf, n_frames);
+	}
+
+	s->cycles = cycle_counter_get() - start;
+	if (s->cycles > s->cycles_max) {
+		s->cycles_max = s->cycles;
+	}
+}
+
+void audio_pipeline_process(uint32_t *frames, uint16_t n_frames) {
+	int32_t *buf = (int32_t*)frames;
+
+	while (n_frames > 0) {
+		const uint16_t n = (n_frames < AUDIO_PIPELINE_BLOCK_FRAMES) ? n_frames : AUDIO_PIPELINE_BLOCK_FRAMES;
+
+		run_stage(&decode_stage, buf, n);
+		for (uint8_t i = 0; i < stage_cnt; ++i) {
+			run_stage(stages[i], buf, n);
+		}
+		run_stage(&pack_stage, buf, n);
+
+		buf += 2 * n;
+		n_frames -= n;
+	}
+}
+
+static void print_stage(AudioStage *s) {
+	printf("  %-10s %s %6lu %6lu\n", s->name, s->enabled ? "on " : "off", s->cycles, s->cycles_max);
+	s->cycles_max = 0;
+}
+
+void audio_pipeline_print_stats(void) {
+	printf("pipeline stage      cycles    max\n");
+	print_stage(&decode_stage);
+	for (uint8_t i = 0; i < stage_cnt; ++i) {
+		print_stage(stages[i]);
+	}
+	print_stage(&pack_stage);
+}
@@ -0,0 +1,107 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "audio_preroll.h"
+#include "custom_math.h"
+#include <string.h>
+
+PrerollStats preroll_stats = { .preroll = PREROLL_DEFAULT, .fifo_min = UINT16_MAX };
+
+// when the given pre-roll underrun the last time (0 - never)
+static uint32_t preroll_underrun_ms[PREROLL_MAX + 1];
+// jitter of the current and the previous window, so the max covers at least one full window
+static volatile uint32_t jitter_curr_us;
+static uint32_t jitter_prev_us;
+static uint32_t window_start_ms;
+
+void audio_preroll_reset(void) {
+	memset(&preroll_stats, 0, sizeof(preroll_stats));
+	preroll_stats.preroll = PREROLL_DEFAULT;
+	preroll_stats.fifo_min = UINT16_MAX;
+	memset(preroll_underrun_ms, 0, sizeof(preroll_underrun_ms));
+	jitter_curr_us = 0;
+	jitter_prev_us = 0;
+	window_start_ms = 0;
+}
+
+void audio_preroll_packet(uint32_t interval_us, uint16_t fill, bool playing) {
+	// a long gap is a stream (re)start and not jitter
+	if (interval_us < 100000) {
+		const uint32_t jitter_us = ABS((int32_t)interval_us - 1000);
+		jitter_curr_us = MAX(jitter_curr_us, jitter_us);
+	}
+
+	if (playing) {
+		preroll_stats.fifo_min = MIN(preroll_stats.fifo_min, fill);
+	}
+}
+
+void audio_preroll_started(void) {
+	preroll_stats.fifo_min = UINT16_MAX;
+}
+
+// marks the current and all the smaller pre-rolls as not good enough
+static void block_preroll(uint32_t curr_ms) {
+	// (+1 so the 0 is free to mean "never")
+	for (uint8_t p = 0; p <= preroll_stats.preroll; ++p) {
+		preroll_underrun_ms[p] = curr_ms + 1;
+	}
+}
+
+void audio_preroll_update(uint32_t curr_ms, bool underrun, uint16_t packet_len) {
+	if (curr_ms - window_start_ms >= PREROLL_WINDOW_MS) {
+		window_start_ms = curr_ms;
+		jitter_prev_us = jitter_curr_us;
+		jitter_curr_us = 0;
+	}
+	preroll_stats.jitter_max_us = MAX(jitter_prev_us, jitter_curr_us);
+
+	if (underrun) {
+		++preroll_stats.underruns;
+		block_preroll(curr_ms);
+	}
+
+	// The fill is taken right after a packet was written, so without it the FIFO had less than a packet,
+	// the level where audio_task() stops the playback. Only the main loop did not look at that moment,
+	// so the pre-roll has no margin and is treated like one which underrun.
+	// A lost update of fifo_min by the ISR meanwhile only delays this to its next packet.
+	if (preroll_stats.fifo_min < 2 * packet_len) {
+		preroll_stats.fifo_min = UINT16_MAX;
+		++preroll_stats.near_underruns;
+		block_preroll(curr_ms);
+	}
+
+	// 1 packet is always needed, and 1 more for each started ms of jitter
+	uint8_t preroll = 1 + (preroll_stats.jitter_max_us + 999) / 1000;
+	preroll = MAX(preroll, PREROLL_MIN);
+
+	while ((preroll < PREROLL_MAX) && (preroll_underrun_ms[preroll] != 0)
+			&& (curr_ms + 1 - preroll_underrun_ms[preroll] < PREROLL_WINDOW_MS)) {
+		++preroll;
+	}
+
+	preroll_stats.preroll = MIN(preroll, PREROLL_MAX);
+}
@@ -0,0 +1,184 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "audio_salvage.h"
+#include "custom_math.h"
+#include <string.h>
+
+// 24bit stereo
+#define FRAME_LEN   6
+
+AudioSalvageStats audio_salvage_stats;
+
+// upper 16bit of a sample, it is plenty to see a byte shift
+static inline int32_t up16(const uint8_t *p) {
+	return (int16_t)((p[2] << 8) | p[1]);
+}
+
+// difference of two frames
+static inline uint32_t frame_diff(const uint8_t *a, const uint8_t *b) {
+	const int32_t l = up16(&a[0]) - up16(&b[0]);
+	const int32_t r = up16(&a[3]) - up16(&b[3]);
+	return ABS(l) + ABS(r);
+}
+
+// how far 'b' is off the line through 'a2' and 'a' after 'span' steps,
+// without 'a2' it is just the step from 'a' to 'b' scaled to 1 step
+static inline uint32_t gap_diff(const uint8_t *a, const uint8_t *b, const uint8_t *a2, uint16_t span) {
+	uint32_t d = 0;
+	for (uint8_t ch = 0; ch < FRAME_LEN; ch += 3) {
+		const int32_t slope = (a2 != NULL) ? up16(&a[ch]) - up16(&a2[ch]) : 0;
+		const int32_t e = up16(&b[ch]) - up16(&a[ch]) - slope * span;
+		d += ABS(e);
+	}
+	return (a2 != NULL) ? d : d / span;
+}
+
+static inline int32_t get_s24(const uint8_t *p) {
+	return (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)) >> 8;
+}
+
+static inline void put_s24(uint8_t *p, int32_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+}
+
+uint16_t audio_salvage_packet(uint8_t *dst, const uint8_t *src, uint16_t n, const uint8_t *prev_frame) {
+	++audio_salvage_stats.packets;
+
+	// q whole frames in both alignments:
+	//   A - the original one, frames at 0, 6, 12, ...
+	//   B - shifted by the misalignment, frames at m, m + 6, ...
+	const uint16_t q = n / FRAME_LEN;
+	const uint16_t m = n % FRAME_LEN;
+	const uint8_t *A = src;
+	const uint8_t *B = &src[m];
+
+	if (q == 0) {
+		++audio_salvage_stats.dropped;
+		return 0;
+	}
+
+	// The result is A[0 .. f-1] + 1 (or 2) interpolated frame(s) + B[g .. q-1]
+	//   g = f   - bytes were lost, the interpolated frame replaces the broken one
+	//   g = f+1 - bytes were inserted (or lost over 2 frames), B[f] is broken as well
+	// A shift by a half frame (3 bytes) just swaps L/R, so it is found only by the step at the split
+	// cost = roughness of the A prefix + the step over the gap + roughness of the B suffix
+	uint32_t cost_b = 0; // roughness of B[f ..]
+	for (uint16_t j = 1; j < q; ++j) {
+		cost_b += frame_diff(&B[j * FRAME_LEN], &B[(j - 1) * FRAME_LEN]);
+	}
+
+	uint32_t cost_a = 0; // roughness of A[.. f-1]
+	uint32_t best_cost = UINT32_MAX;
+	uint16_t best_f = 0;
+	uint16_t best_g = 0;
+
+	for (uint16_t f = 0; f <= q; ++f) {
+		if (f >= 2) {
+			cost_a += frame_diff(&A[(f - 1) * FRAME_LEN], &A[(f - 2) * FRAME_LEN]);
+		}
+
+		// roughness of B[f+1 ..]
+		const uint32_t cost_b1 = (f + 1 < q) ? cost_b - frame_diff(&B[(f + 1) * FRAME_LEN], &B[f * FRAME_LEN]) : 0;
+
+		for (uint16_t g = f; (g <= f + 1) && (g <= q); ++g) {
+			// the frame before the gap, at the start it is the last frame of the previous packet
+			const uint8_t *before = (f > 0) ? &A[(f - 1) * FRAME_LEN] : prev_frame;
+
+			// The gap spans 2 or 3 steps, a shifted frame after it which just happens to be close
+			// would pass a plain step, so it is checked against the slope before the gap.
+			// Every candidate is compared over q steps: the ones it does not have (without a frame
+			// before or after the gap, or dropped with B[f]) count as the average step, otherwise
+			// the end (or the start) of the packet would be always the cheapest place for the split
+			const uint32_t avg = (q > 1) ? (cost_a + cost_b) / (q - 1) : 0;
+			uint32_t cost = cost_a + ((g == f) ? cost_b : cost_b1);
+			uint16_t steps = ((f > 0) ? f - 1 : 0) + ((g < q) ? q - g - 1 : 0);
+			if ((before != NULL) && (g < q)) {
+				cost += gap_diff(before, &B[g * FRAME_LEN], (f > 1) ? &A[(f - 2) * FRAME_LEN] : NULL, g - f + 2);
+				++steps;
+			}
+			cost += avg * (q - steps);
+
+			// on a tie the later split (and the less dropped data) wins, e.g. silence is just the prefix
+			if ((cost < best_cost) || ((cost == best_cost) && (g == f))) {
+				best_cost = cost;
+				best_f = f;
+				best_g = g;
+			}
+		}
+
+		cost_b = cost_b1;
+	}
+
+	if (best_f == q) {
+		++audio_salvage_stats.tail;
+	} else if (best_f == 0) {
+		++audio_salvage_stats.head;
+	} else {
+		++audio_salvage_stats.split;
+	}
+
+	// aligned prefix
+	memcpy(dst, A, best_f * FRAME_LEN);
+	uint8_t *out = &dst[best_f * FRAME_LEN];
+
+	// the broken frame(s) are interpolated from the neighbours (or held at the packet's edge)
+	const uint8_t *prev = (best_f > 0) ? &A[(best_f - 1) * FRAME_LEN] : prev_frame;
+	const uint8_t *next = (best_g < q) ? &B[best_g * FRAME_LEN] : prev;
+	prev = (prev != NULL) ? prev : next;
+
+	// B[f] is broken when bytes were inserted, or when the lost bytes spanned 2 frames.
+	// In the latter case 2 frames are missing, it is decided by which one continues the slope better
+	uint8_t gap = 1;
+	if ((best_g == best_f + 1) && (best_f >= 2) && (best_g < q)) {
+		const uint8_t *prev2 = &A[(best_f - 2) * FRAME_LEN];
+		int32_t err1 = 0;
+		int32_t err2 = 0;
+		for (uint8_t ch = 0; ch < FRAME_LEN; ch += 3) {
+			const int32_t slope = get_s24(&prev[ch]) - get_s24(&prev2[ch]);
+			const int32_t step = get_s24(&next[ch]) - get_s24(&prev[ch]);
+			err1 += ABS(step - 2 * slope);
+			err2 += ABS(step - 3 * slope);
+		}
+		gap = (err2 < err1) ? 2 : 1;
+	}
+
+	for (uint8_t i = 1; i <= gap; ++i) {
+		for (uint8_t ch = 0; ch < FRAME_LEN; ch += 3) {
+			const int32_t a = get_s24(&prev[ch]);
+			const int32_t b = get_s24(&next[ch]);
+			put_s24(&out[ch], a + (b - a) * i / (gap + 1));
+		}
+		out += FRAME_LEN;
+	}
+
+	// realigned rest
+	memcpy(out, &B[best_g * FRAME_LEN], (q - best_g) * FRAME_LEN);
+
+	return (uint16_t)((best_f + gap + q - best_g) * FRAME_LEN);
+}
@@ -0,0 +1,131 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "audio_tone.h"
+#include "audio_biquad.h"
+#include "tone_table.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FLAT_STEP   (-TONE_TABLE_MIN_DB_X10 / TONE_TABLE_STEP_DB_X10)
+
+// published by the main loop, a single word write each, so the refill sees either the old or the new one
+static const AudioBiquadQ31Coef *volatile bass;
+static const AudioBiquadQ31Coef *volatile treb;
+
+static bool available;
+
+// used by the refill
+static AudioBiquadQ31 stages[2];
+static const AudioBiquadQ31Coef *active[2];
+
+static bool tone_active(void);
+
+AudioStage audio_tone_stage = {
+	.name = "tone",
+	.process = audio_tone_process,
+	.active = tone_active,
+	.reset = audio_tone_reset,
+	.set_sample_rate = audio_tone_set_sample_rate,
+	.enable_req = true,
+};
+
+static const AudioBiquadQ31Coef* lookup(const AudioBiquadQ31Coef table[TONE_TABLE_FREQ_CNT][TONE_TABLE_STEPS],
+		uint8_t freq_id, int16_t gain_db_x10) {
+	int16_t step = (gain_db_x10 - TONE_TABLE_MIN_DB_X10) / TONE_TABLE_STEP_DB_X10;
+	if (step < 0) {
+		step = 0;
+	}
+	if (step >= TONE_TABLE_STEPS) {
+		step = TONE_TABLE_STEPS - 1;
+	}
+	if (freq_id >= TONE_TABLE_FREQ_CNT) {
+		freq_id = TONE_TABLE_FREQ_CNT - 1;
+	}
+	// flat is the same for all frequencies, so tone_active() has to check only one entry
+	if (step == FLAT_STEP) {
+		freq_id = 0;
+	}
+	return &table[freq_id][step];
+}
+
+bool audio_tone_init(uint32_t sample_rate) {
+	bass = &tone_bass_table[0][FLAT_STEP];
+	treb = &tone_treb_table[0][FLAT_STEP];
+	active[0] = active[1] = NULL;
+	memset(stages, 0, sizeof(stages));
+
+	audio_tone_set_sample_rate(sample_rate);
+	return available;
+}
+
+void audio_tone_set_sample_rate(uint32_t sample_rate) {
+	available = (sample_rate == TONE_TABLE_FS);
+	if (!available) {
+		printf("tone: the table is for %uHz, not for %luHz\n", TONE_TABLE_FS, sample_rate);
+	}
+	memset(stages, 0, sizeof(stages));
+	active[0] = active[1] = NULL;
+	audio_pipeline_enable(&audio_tone_stage, available);
+}
+
+bool audio_tone_available(void) {
+	return available;
+}
+
+void audio_tone_set_bass(uint8_t freq_id, int16_t gain_db_x10) {
+	bass = lookup(tone_bass_table, freq_id, gain_db_x10);
+}
+
+void audio_tone_set_treble(uint8_t freq_id, int16_t gain_db_x10) {
+	treb = lookup(tone_treb_table, freq_id, gain_db_x10);
+}
+
+void audio_tone_reset(void) {
+	memset(stages[0].st, 0, sizeof(stages[0].st));
+	memset(stages[1].st, 0, sizeof(stages[1].st));
+}
+
+// both flat, nothing to do
+static bool tone_active(void) {
+	return (bass != &tone_bass_table[0][FLAT_STEP]) || (treb != &tone_treb_table[0][FLAT_STEP]);
+}
+
+void audio_tone_process(int32_t *buf, uint16_t n_frames) {
+	const AudioBiquadQ31Coef *b = bass;
+	const AudioBiquadQ31Coef *t = treb;
+
+	if (b != active[0]) {
+		stages[0].coef = *b;
+		active[0] = b;
+	}
+	if (t != active[1]) {
+		stages[1].coef = *t;
+		active[1] = t;
+	}
+
+	audio_biquad_cascade(buf, n_frames, stages, 2);
+}
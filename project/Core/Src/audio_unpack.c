@@ -0,0 +1,228 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "audio_unpack.h"
+#include "audio_common.h"
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+#include "stm32f4xx.h" // CMSIS intrinsics
+#else
+// host build, so the kernel can be checked against the reference on a PC
+static inline uint32_t __ROR(uint32_t x, uint32_t n) {
+	n %= 32;
+	return n == 0 ? x : (x >> n) | (x << (32 - n));
+}
+
+static inline uint32_t __PKHBT(uint32_t a, uint32_t b, uint32_t shift) {
+	return (a & 0x0000FFFF) | ((b << shift) & 0xFFFF0000);
+}
+#endif
+
+// the lowest byte of the less significant half word is always zero
+#define I2S_24BIT_MASK   0xFF00FFFF
+
+typedef struct __attribute__((packed)) {
+	uint32_t val;
+} unaligned_u32;
+
+static inline uint32_t read_u32(const uint8_t *src) {
+	return ((const unaligned_u32*)src)->val;
+}
+
+void unpack_24_to_i2s_ref(uint8_t *dst, const uint8_t *src, uint16_t n) {
+	for (uint16_t i = 0; i < n; ++i) {
+		// This might be confusing, but it is needed as we pass virtually 2x16bits onto the DAC.
+		// Each 16bit has a buff[1]-> MSB and buff[0]-> LSB because endian-ness
+		// can be better seen in an union.
+		// But the 2x 16Bit buffer is the opposite because how the I2S works:
+		// more sensitive 16bit first, less sensitive 16bit last
+		// so the mapping is
+		//   USB   array:  0, 1, 2 -> LSB, MID, MSB
+		//   I2S   array:  MSB[ LSB,  MSB  ] + LSB[ LSB, MSB  ]
+		//   e.g.          MSB[ USB1, USB2 ] + LSB[   0, USB0 ]
+
+		dst[i*4+1] = src[i*3 + 2];
+		dst[i*4+0] = src[i*3 + 1];
+
+		dst[i*4+3] = src[i*3 + 0];
+		dst[i*4+2] = 0;
+	}
+}
+
+void unpack_24_to_i2s(uint8_t *dst, const uint8_t *src, uint16_t n) {
+	uint32_t *out = (uint32_t*)dst;
+
+	// 4 samples are exactly 3 words, with a little endian load they look like
+	//   w0 = [ A0 A1 A2 B0 ]
+	//   w1 = [ B1 B2 C0 C1 ]
+	//   w2 = [ C2 D0 D1 D2 ]
+	// and the output word of a sample X (little endian store) has to be
+	//   [ X1 X2 0 X0 ]
+	for (; n >= 4; n -= 4) {
+		const uint32_t w0 = read_u32(&src[0]);
+		const uint32_t w1 = read_u32(&src[4]);
+		const uint32_t w2 = read_u32(&src[8]);
+
+		// [ A1 A2 B0 A0 ]
+		out[0] = __ROR(w0, 8) & I2S_24BIT_MASK;
+		// [ B1 B2 -- B0 ] bottom half from w1, top half from w0
+		out[1] = __PKHBT(w1, w0, 0) & I2S_24BIT_MASK;
+		// [ C1 -- -- C0 ] + C2 from w2
+		out[2] = (__ROR(w1, 24) & 0xFF0000FF) | ((w2 << 8) & 0x0000FF00);
+		// [ D1 D2 C2 D0 ]
+		out[3] = __ROR(w2, 16) & I2S_24BIT_MASK;
+
+		src += 12;
+		out += 4;
+	}
+
+	// the rest (max 3 samples)
+	for (; n > 0; --n) {
+		out[0] = src[1] | (src[2] << 8) | ((uint32_t)src[0] << 24);
+		src += 3;
+		out += 1;
+	}
+}
+
+void unpack_16_to_i2s(uint8_t *dst, const uint8_t *src, uint16_t n) {
+	uint32_t *out = (uint32_t*)dst;
+
+	// the Q31 value of a 16bit sample is X << 16, so its frame is [ X0 X1 0 0 ]
+	//   w0 = [ A0 A1 B0 B1 ]
+	//   w1 = [ C0 C1 D0 D1 ]
+	for (; n >= 4; n -= 4) {
+		const uint32_t w0 = read_u32(&src[0]);
+		const uint32_t w1 = read_u32(&src[4]);
+
+		out[0] = w0 & 0x0000FFFF;
+		out[1] = w0 >> 16;
+		out[2] = w1 & 0x0000FFFF;
+		out[3] = w1 >> 16;
+
+		src += 8;
+		out += 4;
+	}
+
+	for (; n > 0; --n) {
+		out[0] = src[0] | (src[1] << 8);
+		src += 2;
+		out += 1;
+	}
+}
+
+void unpack_32_to_i2s(uint8_t *dst, const uint8_t *src, uint16_t n) {
+	uint32_t *out = (uint32_t*)dst;
+
+	// the subslot is already a Q31 value [ X0 X1 X2 X3 ] (X0 is padding), the frame is [ X2 X3 0 X1 ]
+	for (; n >= 4; n -= 4) {
+		out[0] = __ROR(read_u32(&src[0]), 16) & I2S_24BIT_MASK;
+		out[1] = __ROR(read_u32(&src[4]), 16) & I2S_24BIT_MASK;
+		out[2] = __ROR(read_u32(&src[8]), 16) & I2S_24BIT_MASK;
+		out[3] = __ROR(read_u32(&src[12]), 16) & I2S_24BIT_MASK;
+
+		src += 16;
+		out += 4;
+	}
+
+	for (; n > 0; --n) {
+		out[0] = __ROR(read_u32(src), 16) & I2S_24BIT_MASK;
+		src += 4;
+		out += 1;
+	}
+}
+
+AudioUnpackFunc unpack_get_kernel(uint8_t bytes_per_sample) {
+	switch (bytes_per_sample) {
+	case 2: return unpack_16_to_i2s;
+	case 3: return unpack_24_to_i2s;
+	case 4: return unpack_32_to_i2s;
+	default: return NULL;
+	}
+}
+
+#if CFG_AUDIO_BENCHMARK
+#include "cycle_counter.h"
+#include <stdio.h>
+
+// 1ms of stereo audio
+#define BENCH_SAMPLES 96
+
+// byte wise references of the 16 and 32bit kernels, through the Q31 value
+static void unpack_16_ref(uint32_t *dst, const uint8_t *src, uint16_t n) {
+	for (uint16_t i = 0; i < n; ++i) {
+		const int16_t s = (int16_t)(src[i*2] | (src[i*2 + 1] << 8));
+		dst[i] = q31_to_i2s_frame((int32_t)s * 65536);
+	}
+}
+
+static void unpack_32_ref(uint32_t *dst, const uint8_t *src, uint16_t n) {
+	for (uint16_t i = 0; i < n; ++i) {
+		const uint32_t s = src[i*4] | (src[i*4 + 1] << 8) | (src[i*4 + 2] << 16) | ((uint32_t)src[i*4 + 3] << 24);
+		dst[i] = q31_to_i2s_frame((int32_t)s);
+	}
+}
+
+void unpack_benchmark(void) {
+	static uint8_t src[BENCH_SAMPLES * 4];
+	static uint32_t dst_ref[BENCH_SAMPLES];
+	static uint32_t dst[BENCH_SAMPLES];
+
+	for (uint16_t i = 0; i < sizeof(src); ++i) {
+		src[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	cycle_counter_init();
+
+	uint32_t start = cycle_counter_get();
+	unpack_24_to_i2s_ref((uint8_t*)dst_ref, src, BENCH_SAMPLES);
+	const uint32_t cycles_ref = cycle_counter_get() - start;
+
+	start = cycle_counter_get();
+	unpack_24_to_i2s((uint8_t*)dst, src, BENCH_SAMPLES);
+	const uint32_t cycles = cycle_counter_get() - start;
+
+	printf("unpack 24bit: ref %lu, word %lu cycles, %s\n", cycles_ref, cycles,
+			memcmp(dst_ref, dst, sizeof(dst)) == 0 ? "match" : "MISMATCH");
+
+	unpack_16_ref(dst_ref, src, BENCH_SAMPLES);
+	start = cycle_counter_get();
+	unpack_16_to_i2s((uint8_t*)dst, src, BENCH_SAMPLES);
+	const uint32_t cycles_16 = cycle_counter_get() - start;
+
+	printf("unpack 16bit: %lu cycles, %s\n", cycles_16,
+			memcmp(dst_ref, dst, sizeof(dst)) == 0 ? "match" : "MISMATCH");
+
+	unpack_32_ref(dst_ref, src, BENCH_SAMPLES);
+	start = cycle_counter_get();
+	unpack_32_to_i2s((uint8_t*)dst, src, BENCH_SAMPLES);
+	const uint32_t cycles_32 = cycle_counter_get() - start;
+
+	printf("unpack 32bit: %lu cycles, %s\n", cycles_32,
+			memcmp(dst_ref, dst, sizeof(dst)) == 0 ? "match" : "MISMATCH");
+}
+#endif
@@ -0,0 +1,205 @@
+/**
+ Copyright (c) 2026 tomix89
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to use,
+ copy, modify, and distribute the Software for non-commercial purposes only,
+ subject to the following conditions:
+
+ 1. Attribution: All copies or substantial portions of the Software must
+ retain this copyright notice and the original author information.
+
+ 2. Open-Source Requirement: Any modified versions of the Software must be
+ distributed under this same license and made publicly available in source
+ form.
+
+ 3. Non-Commercial Use: The Software may not be used for commercial purposes
+ without explicit written permission from the author.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "audio_volume.h"
+#include "CS43L22_driver.h"
+#include "stm32f4xx_hal.h"
+#include "custom_math.h"
+#include <math.h>
+
+// unity gain in Q31
+#define GAIN_UNITY      INT32_MAX
+
+// 1-pole smoothing: gain += (target - gain) / 2^SMOOTH_SHIFT per sample, ~2.7ms time constant at 48kHz
+#define SMOOTH_SHIFT    7
+
+AudioVolumeStats audio_volume_stats;
+
+// main loop side, all x10 dB
+static int16_t target_db[2];
+static int16_t codec_db[2];
+static int16_t headroom_db;
+static bool commit_pending;
+static uint32_t last_change_ms;
+static uint32_t last_commit_ms;
+
+// written by the main loop, followed by the refill
+static volatile int32_t gain_target[2];
+// refill only
+static int32_t gain[2];
+
+static bool volume_active(void);
+static void volume_process(int32_t *buf, uint16_t n_frames);
+
+AudioStage audio_volume_stage = {
+	.name = "volume",
+	.process = volume_process,
+	.active = volume_active,
+	.enable_req = true,
+};
+
+static int32_t db_x10_to_q31(int16_t db_x10) {
+	if (db_x10 >= 0) {
+		return GAIN_UNITY;
+	}
+	return (int32_t)(powf(10.0f, (float)db_x10 / 200.0f) * 2147483647.0f);
+}
+
+// the codec setting which covers 'db' with the smallest digital attenuation
+static inline int16_t coarse_db(int16_t db) {
+	// rounded towards 0dB, db is never positive
+	return -((-db) / AUDIO_VOLUME_COARSE_DB_X10) * AUDIO_VOLUME_COARSE_DB_X10;
+}
+
+// the codec setting for the target with the headroom
+static inline int16_t codec_target_db(uint8_t ch) {
+	return coarse_db(MIN(target_db[ch] + headroom_db, 0));
+}
+
+// below the digital range it is still attenuated as much as possible until the codec is written
+static void update_digital(void) {
+	gain_target[0] = db_x10_to_q31(MAX(target_db[0] - codec_db[0], -AUDIO_VOLUME_DIGITAL_DB_X10));
+	gain_target[1] = db_x10_to_q31(MAX(target_db[1] - codec_db[1], -AUDIO_VOLUME_DIGITAL_DB_X10));
+}
+
+// 'step' - the codec goes down by max one coarse step, the rest is left for the next commits
+static void commit_codec(bool step) {
+	commit_pending = false;
+	for (uint8_t ch = 0; ch < 2; ++ch) {
+		int16_t db = codec_target_db(ch);
+		if (step && (db < codec_db[ch] - AUDIO_VOLUME_COARSE_DB_X10)) {
+			db = codec_db[ch] - AUDIO_VOLUME_COARSE_DB_X10;
+			commit_pending = true;
+		}
+		codec_db[ch] = db;
+	}
+	last_commit_ms = HAL_GetTick();
+
+	// The codec ramps its own volume change (soft ramp) and the digital gain is smoothed over a few ms,
+	// so they are not sample aligned. While they move in opposite directions the level is off by up to
+	// the smaller move, max one coarse step: going up the digital gain changes by less than a coarse step,
+	// going down (deferred) the codec moves only one coarse step per commit.
+	update_digital();
+	// 0.5dB format for CS43L22
+	CS43L22_set_hp_volume_db(codec_db[0] / 5, codec_db[1] / 5);
+	++audio_volume_stats.codec_writes;
+}
+
+void audio_volume_init(void) {
+	target_db[0] = target_db[1] = 0;
+	codec_db[0] = codec_db[1] = 0;
+	headroom_db = 0;
+	gain_target[0] = gain_target[1] = GAIN_UNITY;
+	gain[0] = gain[1] = GAIN_UNITY;
+	commit_pending = false;
+}
+
+void audio_volume_set_db_x10(int16_t vol_l, int16_t vol_r) {
+	target_db[0] = MIN(vol_l, 0);
+	target_db[1] = MIN(vol_r, 0);
+	last_change_ms = HAL_GetTick();
+	++audio_volume_stats.requests;
+
+	if (get_audio_state() == I2S_AUDIO_STOPPED) {
+		commit_codec(false);
+		return;
+	}
+
+	bool below = false;
+	for (uint8_t ch = 0; ch < 2; ++ch) {
+		if (MIN(target_db[ch] + headroom_db, 0) > codec_db[ch]) {
+			// the digital gain can't go above unity, this has to be done by the codec right now
+			commit_codec(false);
+			return;
+		}
+		if (target_db[ch] < codec_db[ch] - AUDIO_VOLUME_DIGITAL_DB_X10) {
+			below = true;
+		}
+	}
+
+	update_digital();
+	commit_pending = below;
+}
+
+void audio_volume_set_headroom_db_x10(int16_t headroom) {
+	headroom_db = MAX(headroom, 0);
+}
+
+void audio_volume_task(void) {
+	const bool idle = (get_audio_state() == I2S_AUDIO_STOPPED);
+
+	if (idle) {
+		// move as much as possible to the codec, the digital part is then less than a coarse step
+		if ((codec_db[0] != codec_target_db(0)) || (codec_db[1] != codec_target_db(1))) {
+			commit_codec(false);
+		}
+		return;
+	}
+
+	// the next coarse step only after the digital gain followed the previous one
+	const uint32_t now = HAL_GetTick();
+	if (commit_pending && (now - last_change_ms >= AUDIO_VOLUME_SETTLE_MS)
+			&& (now - last_commit_ms >= AUDIO_VOLUME_STEP_MS)) {
+		commit_codec(true);
+	}
+}
+
+static bool volume_active(void) {
+	return (gain_target[0] != GAIN_UNITY) || (gain_target[1] != GAIN_UNITY)
+			|| (gain[0] != GAIN_UNITY) || (gain[1] != GAIN_UNITY);
+}
+
+static inline int32_t smooth(int32_t g, int32_t target) {
+	const int32_t step = (target - g) >> SMOOTH_SHIFT;
+	// the last few LSBs would never be reached by the shift
+	return (step == 0) ? target : g + step;
+}
+
+static void volume_process(int32_t *buf, uint16_t n_frames) {
+	const int32_t tl = gain_target[0];
+	const int32_t tr = gain_target[1];
+	int32_t gl = gain[0];
+	int32_t gr = gain[1];
+
+	if ((gl == tl) && (gr == tr)) {
+		// steady state, only the multiplication
+		for (uint16_t i = 0; i < n_frames; ++i) {
+			buf[2 * i + 0] = (int32_t)(((int64_t)buf[2 * i + 0] * gl) >> 31);
+			buf[2 * i + 1] = (int32_t)(((int64_t)buf[2 * i + 1] * gr) >> 31);
+		}
+		return;
+	}
+
+	for (uint16_t i = 0; i < n_frames; ++i) {
+		gl = smooth(gl, tl);
+		gr = smooth(gr, tr);
+		buf[2 * i + 0] = (int32_t)(((int64_t)buf[2 * i + 0] * gl) >> 31);
+		buf[2 * i + 1] = (int32_t)(((int64_t)buf[2 * i + 1] * gr) >> 31);
+	}
+
+	gain[0] = gl;
+	gain[1] = gr;
+}
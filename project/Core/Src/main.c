@@ -39,6 +39,18 @@ SOFTWARE.
 #include "audio_controls.h"
 #include "ssd1306.h"
 #include "UI_control.h"
+#include "audio_unpack.h"
+#include "audio_asrc.h"
+#include "audio_biquad.h"
+#include "audio_eq.h"
+#include "audio_pipeline.h"
+#include "audio_volume.h"
+#include "audio_crossfeed.h"
+#include "audio_loudness.h"
+#include "audio_limiter.h"
+#include "audio_tone.h"
+#include "audio_dither.h"
+#include "cycle_counter.h"
 
 /* USER CODE END Includes */
 
@@ -147,6 +159,8 @@ int main(void)
   MX_I2S3_Init();
   MX_SPI5_Init();
   /* USER CODE BEGIN 2 */
+  // used to measure the USB packet timing and the audio path
+  cycle_counter_init();
 
   // initialize OLED display
   if (SSD1306_Init(&hspi5) != SSD1306_OK) {
@@ -165,9 +179,47 @@ int main(void)
 	  Error_Handler();
   }
 
+  // the DSP stages of the refill, in processing order
+  audio_eq_init(AUDIO_SAMPLING_RATE);
+  audio_pipeline_init();
+#if CFG_AUDIO_DIGITAL_VOLUME
+  audio_volume_init();
+  audio_pipeline_add(&audio_volume_stage);
+#endif
+#if CFG_AUDIO_LOUDNESS
+  audio_loudness_init(AUDIO_SAMPLING_RATE);
+  audio_pipeline_add(&audio_loudness_stage);
+#endif
+  audio_pipeline_add(&audio_eq_stage);
+  audio_crossfeed_init(AUDIO_SAMPLING_RATE);
+  audio_pipeline_add(&audio_crossfeed_stage);
+#if CFG_AUDIO_LIMITER
+  audio_limiter_init(AUDIO_SAMPLING_RATE);
+  audio_pipeline_add(&audio_limiter_stage);
+#endif
+#if CFG_AUDIO_SOFT_TONE
+  // after the limiter, like the codec's tone control
+  audio_tone_init(AUDIO_SAMPLING_RATE);
+  audio_pipeline_add(&audio_tone_stage);
+#endif
+#if CFG_AUDIO_DITHER
+  audio_dither_init(CFG_AUDIO_DITHER);
+  audio_pipeline_add(&audio_dither_stage);
+#endif
+
   audio_init();
   ui_init();
 
+#if CFG_AUDIO_BENCHMARK
+  unpack_benchmark();
+  audio_asrc_benchmark();
+  audio_biquad_benchmark();
+  audio_eq_benchmark();
+  audio_crossfeed_benchmark();
+  audio_limiter_benchmark();
+  audio_dither_benchmark();
+#endif
+
   printf("init done\n");
   /* USER CODE END 2 */
 
@@ -187,6 +239,15 @@ int main(void)
 #endif
 
 	 audio_task();
+	 audio_controls_task();
+
+#if CFG_AUDIO_DIGITAL_VOLUME
+	 audio_volume_task();
+#endif
+
+#if CFG_AUDIO_LIMITER
+	 audio_limiter_task();
+#endif
   }
   /* USER CODE END 3 */
 }
@@ -128,18 +128,33 @@ uint8_t const * tud_hid_descriptor_report_cb(uint8_t itf) {
   #define EPNUM_DEBUG       0x02
 #endif
 
+// the OTG FS FIFO RAM in words: the RX FIFO as tinyusb sizes it (dcd_dwc2.c, 4 EPs) + EP0 IN + feedback EP IN + HID EP IN
+#define OTG_FS_FIFO_WORDS           320
+#define OTG_FS_FIFO_USED            ((13 + 1 + 2 * (CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS / 4 + 1) + 2 * 4) \
+                                     + CFG_TUD_ENDPOINT0_SIZE / 4 + 1 + CFG_AUDIO_DEBUG * CFG_TUD_HID_EP_BUFSIZE / 4)
+
+TU_VERIFY_STATIC(OTG_FS_FIFO_USED <= OTG_FS_FIFO_WORDS, "The endpoints do not fit into the OTG FS FIFO, lower the max sample rate");
+
+#define UAC1_AUDIO_DESC_LEN         (TUD_AUDIO10_SPEAKER_STEREO_FB_DESC_LEN \
+                                     + 2 * TUD_AUDIO10_SPEAKER_STREAM_ALT_DESC_LEN(AUDIO_SAMPLE_RATE_CNT) \
+                                     + TUD_AUDIO10_SPEAKER_STREAM_ALT_DESC_LEN(AUDIO_SAMPLE_RATE_CNT_32BIT))
+
 #if CFG_AUDIO_DEBUG
-  #define CONFIG_UAC1_TOTAL_LEN    	(TUD_CONFIG_DESC_LEN + TUD_AUDIO10_SPEAKER_STEREO_FB_DESC_LEN(1) + TUD_HID_DESC_LEN)
+  #define CONFIG_UAC1_TOTAL_LEN    	(TUD_CONFIG_DESC_LEN + UAC1_AUDIO_DESC_LEN + TUD_HID_DESC_LEN)
 #else
-  #define CONFIG_UAC1_TOTAL_LEN    	(TUD_CONFIG_DESC_LEN + TUD_AUDIO10_SPEAKER_STEREO_FB_DESC_LEN(1))
+  #define CONFIG_UAC1_TOTAL_LEN    	(TUD_CONFIG_DESC_LEN + UAC1_AUDIO_DESC_LEN)
 #endif
 
 uint8_t const desc_uac1_configuration[] = {
   // Config number, interface count, string index, total length, attribute, power in mA
   TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_UAC1_TOTAL_LEN, 0x00, 200),
 
-  // Interface number, string index, byte per sample, bit per sample, EP Out, EP size, EP feedback, sample rates (48kHz)
-  TUD_AUDIO10_SPEAKER_STEREO_FB_DESCRIPTOR(ITF_NUM_AUDIO_CONTROL, 5, CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX, CFG_TUD_AUDIO_FUNC_1_RESOLUTION_RX, EPNUM_AUDIO, CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS, EPNUM_AUDIO_FB | 0x80, 48000),
+  // Interface number, string index
+  TUD_AUDIO10_SPEAKER_STEREO_FB_DESCRIPTOR(ITF_NUM_AUDIO_CONTROL, 5),
+  // Interface number, alternate setting, byte per sample, bit per sample, EP Out, EP size, EP feedback, sample rates
+  TUD_AUDIO10_SPEAKER_STREAM_ALT_DESCRIPTOR(ITF_NUM_AUDIO_CONTROL, UAC1_ALT_24BIT, 3, 24, EPNUM_AUDIO, CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS_24BIT, EPNUM_AUDIO_FB | 0x80, AUDIO_SAMPLE_RATES),
+  TUD_AUDIO10_SPEAKER_STREAM_ALT_DESCRIPTOR(ITF_NUM_AUDIO_CONTROL, UAC1_ALT_16BIT, 2, 16, EPNUM_AUDIO, CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS_16BIT, EPNUM_AUDIO_FB | 0x80, AUDIO_SAMPLE_RATES),
+  TUD_AUDIO10_SPEAKER_STREAM_ALT_DESCRIPTOR(ITF_NUM_AUDIO_CONTROL, UAC1_ALT_32BIT, 4, 24, EPNUM_AUDIO, CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS_32BIT, EPNUM_AUDIO_FB | 0x80, AUDIO_SAMPLE_RATES_32BIT),
 
 #if CFG_AUDIO_DEBUG
   // Interface number, string index, protocol, report descriptor len, EP In address, size & polling interval
@@ -149,7 +164,14 @@ uint8_t const desc_uac1_configuration[] = {
 
 TU_VERIFY_STATIC(sizeof(desc_uac1_configuration) == CONFIG_UAC1_TOTAL_LEN, "Incorrect size");
 
+#if AUDIO_UAC2_ENABLED
+
 #if TUD_OPT_HIGH_SPEED
+  #define UAC2_EP_OUT_SZ            CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_HS
+#else
+  // the sample rates are in the clock source range (usb_handler.c), the EP is sized for the highest
+  #define UAC2_EP_OUT_SZ            CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS
+#endif
 
 #if CFG_AUDIO_DEBUG
   #define CONFIG_UAC2_TOTAL_LEN    	(TUD_CONFIG_DESC_LEN + TUD_AUDIO20_SPEAKER_STEREO_FB_DESC_LEN + TUD_HID_DESC_LEN)
@@ -161,8 +183,8 @@ uint8_t const desc_uac2_configuration[] = {
   // Config number, interface count, string index, total length, attribute, power in mA
   TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_UAC2_TOTAL_LEN, 0x00, 100),
 
-  // Interface number, string index, byte per sample, bit per sample, EP Out, EP size, EP feedback, feedback EP size,
-  TUD_AUDIO20_SPEAKER_STEREO_FB_DESCRIPTOR(ITF_NUM_AUDIO_CONTROL, 4, CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX, CFG_TUD_AUDIO_FUNC_1_RESOLUTION_RX, EPNUM_AUDIO, CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_HS, EPNUM_AUDIO_FB | 0x80, 4),
+  // Interface number, string index, byte per sample, bit per sample, EP Out, EP size, EP feedback, feedback EP size (16.16 also on FS),
+  TUD_AUDIO20_SPEAKER_STEREO_FB_DESCRIPTOR(ITF_NUM_AUDIO_CONTROL, 4, CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX, CFG_TUD_AUDIO_FUNC_1_RESOLUTION_RX, EPNUM_AUDIO, UAC2_EP_OUT_SZ, EPNUM_AUDIO_FB | 0x80, 4),
 
 #if CFG_AUDIO_DEBUG
   // Interface number, string index, protocol, report descriptor len, EP In address, size & polling interval
@@ -172,6 +194,10 @@ uint8_t const desc_uac2_configuration[] = {
 
 TU_VERIFY_STATIC(sizeof(desc_uac2_configuration) == CONFIG_UAC2_TOTAL_LEN, "Incorrect size");
 
+#endif // AUDIO_UAC2_ENABLED
+
+#if TUD_OPT_HIGH_SPEED
+
 // device qualifier is mostly similar to device descriptor since we don't change configuration based on speed
 tusb_desc_device_qualifier_t const desc_device_qualifier = {
   .bLength            = sizeof(tusb_desc_device_qualifier_t),
@@ -219,6 +245,8 @@ uint8_t const * tud_descriptor_configuration_cb(uint8_t index) {
   } else {
     return desc_uac2_configuration;
   }
+#elif CFG_AUDIO_UAC2
+    return desc_uac2_configuration;
 #else
     return desc_uac1_configuration;
 #endif
@@ -29,12 +29,20 @@
 #include "bsp/board_api.h"
 #include "common_types.h"
 #include "tusb.h"
+#include "device/dcd.h"
 #include "usb_descriptors.h"
 #include "usb_handler.h"
 
 #include "main.h"
 #include "CS43L22_driver.h"
 #include "audio_controls.h"
+#include "custom_math.h"
+#include "cycle_counter.h"
+#include "audio_feedback.h"
+#include "audio_fifo.h"
+#include "audio_pipeline.h"
+#include "audio_limiter.h"
+#include "audio_preroll.h"
 
 //--------------------------------------------------------------------+
 // MACRO CONSTANT TYPEDEF PROTOTYPES
@@ -55,7 +63,34 @@ enum {
 
 static uint32_t blink_interval_ms = BLINK_NOT_MOUNTED;
 
-#define AUDIO_PACKET_LEN    (AUDIO_SAMPLING_RATE / 1000 * CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX * CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX)
+// the rate selected by the host (SET_CUR), audio_task() switches the I2S to it when it differs from the played one
+static volatile uint32_t usb_sample_rate = AUDIO_SAMPLING_RATE;
+
+// the subslot size of the alternate setting selected by the host, switched the same way as the rate
+static volatile uint8_t usb_sample_bytes = CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX;
+
+// bytes of one stereo frame as it is played (the FIFO is in this format after the switch)
+#define AUDIO_FRAME_BYTES   (audio_get_sample_bytes() * CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX)
+
+// nominal packet of the played rate (the 44.1kHz packets are 44 and 45 frames)
+#define AUDIO_PACKET_LEN    (audio_get_sample_rate() / 1000 * AUDIO_FRAME_BYTES)
+
+// subslot size of a streaming alternate setting, see the UAC1 descriptor (UAC2 has only the 24bit one)
+static uint8_t alt_sample_bytes(uint8_t alt) {
+  if (tud_audio_version() == 1) {
+    switch (alt) {
+      case UAC1_ALT_16BIT: return 2;
+      case UAC1_ALT_32BIT: return 4;
+      default: break;
+    }
+  }
+  return CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX;
+}
+
+// arrival of the previous packet, for the pre-roll jitter
+static uint32_t last_rx_cycles;
+// the playback stopped because the FIFO ran dry while the host was still streaming
+static bool starved;
 
 #if CFG_AUDIO_DEBUG
 void audio_debug_task(void);
@@ -71,6 +106,8 @@ volatile uint32_t fifo_count_avg;
 // Invoked when device is mounted
 void tud_mount_cb(void) {
   blink_interval_ms = BLINK_MOUNTED;
+  // it can be another host, start again from the default pre-roll
+  audio_preroll_reset();
 }
 
 // Invoked when device is unmounted
@@ -110,11 +147,19 @@ static bool audio10_set_req_ep(tusb_control_request_t const *p_request, uint8_t
 
         uint32_t current_sample_rate = tu_unaligned_read32(pBuff) & 0x00FFFFFF;
 
-        if (current_sample_rate != AUDIO_SAMPLING_RATE) {
+        // the descriptor lists only supported rates, so this is a misbehaving host -> STALL
+        if (!audio_is_sample_rate_supported(current_sample_rate)) {
         	TU_LOG2("Setting sample rate %lu is not supported\n", current_sample_rate);
-        	Error_Handler();
+        	return false;
+        }
+        // the 4 byte alternate setting lists fewer rates (its EP size)
+        if ((usb_sample_bytes == 4) && (current_sample_rate > AUDIO_MAX_SAMPLE_RATE_32BIT)) {
+        	TU_LOG2("Setting sample rate %lu is not supported with 4 byte samples\n", current_sample_rate);
+        	return false;
         }
 
+        // the I2S is reconfigured from audio_task(), not from the USB ISR
+        usb_sample_rate = current_sample_rate;
         TU_LOG2("EP set current freq: %" PRIu32 "\r\n", current_sample_rate);
         return true;
       }
@@ -138,9 +183,10 @@ static bool audio10_get_req_ep(uint8_t rhport, tusb_control_request_t const *p_r
         TU_LOG2("EP get current freq\r\n");
 
         uint8_t freq[3];
-        freq[0] = (uint8_t) (AUDIO_SAMPLING_RATE & 0xFF);
-        freq[1] = (uint8_t) ((AUDIO_SAMPLING_RATE >> 8) & 0xFF);
-        freq[2] = (uint8_t) ((AUDIO_SAMPLING_RATE >> 16) & 0xFF);
+        const uint32_t rate = usb_sample_rate;
+        freq[0] = (uint8_t) (rate & 0xFF);
+        freq[1] = (uint8_t) ((rate >> 8) & 0xFF);
+        freq[2] = (uint8_t) ((rate >> 16) & 0xFF);
         return tud_audio_buffer_and_schedule_control_xfer(rhport, p_request, freq, sizeof(freq));
       }
       break;
@@ -154,6 +200,7 @@ static bool audio10_get_req_ep(uint8_t rhport, tusb_control_request_t const *p_r
   return false;
 }
 
+// the volume/mute setters only store the value, the codec (I2C) is updated later from audio_controls_task()
 static bool audio10_set_req_entity(tusb_control_request_t const *p_request, uint8_t *pBuff) {
   uint8_t channelNum = TU_U16_LOW(p_request->wValue);
   uint8_t ctrlSel = TU_U16_HIGH(p_request->wValue);
@@ -168,12 +215,11 @@ static bool audio10_set_req_entity(tusb_control_request_t const *p_request, uint
             // Only 1st form is supported
             TU_VERIFY(p_request->wLength == 1);
 
-            // channelNum == 0 is the master channel
-            // then 1,2 would be L and R - but we have disabled L/R now
-            TU_VERIFY(channelNum == 0);
+            // channelNum == 0 is the master channel, 1,2 are L and R
+            TU_VERIFY(channelNum < AUDIO_USB_CHANNEL_CNT);
             int8_t mute = pBuff[0];
-            audio_set_mute(mute);
-            printf("    Set Mute: %d of channel: %u\r\n", mute, channelNum);
+            audio_set_mute(channelNum, mute);
+            TU_LOG2("    Set Mute: %d of channel: %u\r\n", mute, channelNum);
 
             return true;
 
@@ -187,12 +233,11 @@ static bool audio10_set_req_entity(tusb_control_request_t const *p_request, uint
             // Only 1st form is supported
             TU_VERIFY(p_request->wLength == 2);
 
-            // channelNum == 0 is the master channel
-            // then 1,2 would be L and R - but we have disabled L/R now
-            TU_VERIFY(channelNum == 0);
+            // channelNum == 0 is the master channel, 1,2 are L and R
+            TU_VERIFY(channelNum < AUDIO_USB_CHANNEL_CNT);
             int16_t volume = (int16_t)tu_unaligned_read16(pBuff);
-            audio_set_volume_usb_pct(volume);
-            printf("    Set Volume: %d pct of channel: %u\r\n", volume, channelNum);
+            audio_set_volume_usb_pct(channelNum, volume);
+            TU_LOG2("    Set Volume: %d pct of channel: %u\r\n", volume, channelNum);
 
             return true;
 
@@ -217,12 +262,14 @@ static bool audio10_get_req_entity(uint8_t rhport, tusb_control_request_t const
 
   // If request is for our feature unit
   if (entityID == UAC1_ENTITY_FEATURE_UNIT) {
+    TU_VERIFY(channelNum < AUDIO_USB_CHANNEL_CNT);
+
     switch (ctrlSel) {
       case AUDIO10_FU_CTRL_MUTE:
       {
         // Audio control mute cur parameter block consists of only one byte - we thus can send it right away
         // There does not exist a range parameter block for mute
-    	int8_t mute = audio_get_mute();
+    	int8_t mute = audio_get_mute(channelNum);
     	TU_LOG2("    Get Mute of channel: %u, %u\r\n", channelNum, mute);
         return tud_audio_buffer_and_schedule_control_xfer(rhport, p_request, &mute, 1);
       }
@@ -231,29 +278,29 @@ static bool audio10_get_req_entity(uint8_t rhport, tusb_control_request_t const
         switch (p_request->bRequest) {
           case AUDIO10_CS_REQ_GET_CUR:
           	{
-        	  int16_t volume_pct = audio_get_volume_usb_pct();
-        	  printf("    Get Volume of channel: %u, %u\r\n", channelNum, volume_pct);
+        	  int16_t volume_pct = audio_get_volume_usb_pct(channelNum);
+        	  TU_LOG2("    Get Volume of channel: %u, %u\r\n", channelNum, volume_pct);
               return tud_audio_buffer_and_schedule_control_xfer(rhport, p_request, &volume_pct, sizeof(volume_pct));
             }
 
           case AUDIO10_CS_REQ_GET_MIN:
             {
               int16_t min = USB_MIN_VOLUME_PCT;
-              printf("    Get Volume MIN of channel: %u -> %d\r\n", channelNum, min);
+              TU_LOG2("    Get Volume MIN of channel: %u -> %d\r\n", channelNum, min);
               return tud_audio_buffer_and_schedule_control_xfer(rhport, p_request, &min, sizeof(min));
             }
 
           case AUDIO10_CS_REQ_GET_MAX:
             {
               int16_t max = USB_MAX_VOLUME_PCT;
-              printf("    Get Volume MAX of channel: %u -> %d\r\n", channelNum, max);
+              TU_LOG2("    Get Volume MAX of channel: %u -> %d\r\n", channelNum, max);
               return tud_audio_buffer_and_schedule_control_xfer(rhport, p_request, &max, sizeof(max));
             }
 
           case AUDIO10_CS_REQ_GET_RES:
             {
               int16_t step = USB_VOLUME_STEP;
-        	  printf("    Get Volume STEP of channel: %u -> %d\r\n", channelNum, step);
+        	  TU_LOG2("    Get Volume STEP of channel: %u -> %d\r\n", channelNum, step);
               return tud_audio_buffer_and_schedule_control_xfer(rhport, p_request, &step, sizeof(step));
             }
             // Unknown/Unsupported control
@@ -277,9 +324,9 @@ static bool audio10_get_req_entity(uint8_t rhport, tusb_control_request_t const
 // UAC2 Helper Functions
 //--------------------------------------------------------------------+
 
-#if TUD_OPT_HIGH_SPEED
-// List of supported sample rates for UAC2
-const uint32_t sample_rates[] = {44100, 48000, 88200, 96000};
+#if AUDIO_UAC2_ENABLED
+// the clock source range, the same discrete rates as in the UAC1 format descriptor
+static const uint32_t sample_rates[] = { AUDIO_SAMPLE_RATES };
 
 #define N_SAMPLE_RATES TU_ARRAY_SIZE(sample_rates)
 
@@ -288,27 +335,36 @@ static bool audio20_clock_get_request(uint8_t rhport, audio20_control_request_t
 
   if (request->bControlSelector == AUDIO20_CS_CTRL_SAM_FREQ) {
     if (request->bRequest == AUDIO20_CS_REQ_CUR) {
-      TU_LOG1("Clock get current freq %" PRIu32 "\r\n", current_sample_rate);
+      const uint32_t rate = usb_sample_rate;
+      TU_LOG1("Clock get current freq %" PRIu32 "\r\n", rate);
 
-      audio20_control_cur_4_t curf = {(int32_t) tu_htole32(current_sample_rate)};
+      audio20_control_cur_4_t curf = {(int32_t) tu_htole32(rate)};
       return tud_audio_buffer_and_schedule_control_xfer(rhport, (tusb_control_request_t const *) request, &curf, sizeof(curf));
     } else if (request->bRequest == AUDIO20_CS_REQ_RANGE) {
-      audio20_control_range_4_n_t(N_SAMPLE_RATES) rangef =
-          {
-              .wNumSubRanges = tu_htole16(N_SAMPLE_RATES)};
-      TU_LOG1("Clock get %d freq ranges\r\n", N_SAMPLE_RATES);
+      // only the rates which the PLLI2S table has (and fit into the EP)
+      audio20_control_range_4_n_t(N_SAMPLE_RATES) rangef = {0};
+      uint8_t n = 0;
       for (uint8_t i = 0; i < N_SAMPLE_RATES; i++) {
-        rangef.subrange[i].bMin = (int32_t) sample_rates[i];
-        rangef.subrange[i].bMax = (int32_t) sample_rates[i];
-        rangef.subrange[i].bRes = 0;
-        TU_LOG1("Range %d (%d, %d, %d)\r\n", i, (int) rangef.subrange[i].bMin, (int) rangef.subrange[i].bMax, (int) rangef.subrange[i].bRes);
+        if (!audio_is_sample_rate_supported(sample_rates[i])) {
+          continue;
+        }
+        rangef.subrange[n].bMin = (int32_t) sample_rates[i];
+        rangef.subrange[n].bMax = (int32_t) sample_rates[i];
+        rangef.subrange[n].bRes = 0;
+        TU_LOG1("Range %d (%d, %d, %d)\r\n", n, (int) rangef.subrange[n].bMin, (int) rangef.subrange[n].bMax, (int) rangef.subrange[n].bRes);
+        ++n;
       }
+      rangef.wNumSubRanges = tu_htole16(n);
+      TU_LOG1("Clock get %d freq ranges\r\n", n);
 
-      return tud_audio_buffer_and_schedule_control_xfer(rhport, (tusb_control_request_t const *) request, &rangef, sizeof(rangef));
+      // only the filled subranges, a shorter wLength (e.g. just wNumSubRanges) is cut by the driver
+      return tud_audio_buffer_and_schedule_control_xfer(rhport, (tusb_control_request_t const *) request, &rangef,
+                                                        sizeof(rangef.wNumSubRanges) + n * sizeof(rangef.subrange[0]));
     }
   } else if (request->bControlSelector == AUDIO20_CS_CTRL_CLK_VALID &&
              request->bRequest == AUDIO20_CS_REQ_CUR) {
-    audio20_control_cur_1_t cur_valid = {.bCur = 1};
+    // not valid until audio_task() has switched the I2S to the selected rate
+    audio20_control_cur_1_t cur_valid = {.bCur = (usb_sample_rate == audio_get_sample_rate())};
     TU_LOG1("Clock get is valid %u\r\n", cur_valid.bCur);
     return tud_audio_buffer_and_schedule_control_xfer(rhport, (tusb_control_request_t const *) request, &cur_valid, sizeof(cur_valid));
   }
@@ -324,9 +380,15 @@ static bool audio20_clock_set_request(audio20_control_request_t const *request,
   if (request->bControlSelector == AUDIO20_CS_CTRL_SAM_FREQ) {
     TU_VERIFY(request->wLength == sizeof(audio20_control_cur_4_t));
 
-    current_sample_rate = (uint32_t) ((audio20_control_cur_4_t const *) buf)->bCur;
+    const uint32_t rate = (uint32_t) ((audio20_control_cur_4_t const *) buf)->bCur;
+    if (!audio_is_sample_rate_supported(rate)) {
+      TU_LOG1("Clock set freq %" PRIu32 " is not supported\r\n", rate);
+      return false;
+    }
 
-    TU_LOG1("Clock set current freq: %" PRIu32 "\r\n", current_sample_rate);
+    // the same as the UAC1 EP request, audio_task() does the switch
+    usb_sample_rate = rate;
+    TU_LOG1("Clock set current freq: %" PRIu32 "\r\n", rate);
 
     return true;
   } else {
@@ -336,23 +398,27 @@ static bool audio20_clock_set_request(audio20_control_request_t const *request,
   }
 }
 
+// the master and the L/R channels have the same controls (see TUD_AUDIO20_SPEAKER_STEREO_FB_DESCRIPTOR)
 static bool audio20_feature_unit_get_request(uint8_t rhport, audio20_control_request_t const *request) {
   TU_ASSERT(request->bEntityID == UAC2_ENTITY_FEATURE_UNIT);
+  TU_VERIFY(request->bChannelNumber < AUDIO_USB_CHANNEL_CNT);
 
   if (request->bControlSelector == AUDIO20_FU_CTRL_MUTE && request->bRequest == AUDIO20_CS_REQ_CUR) {
-    audio20_control_cur_1_t mute1 = {.bCur = mute[request->bChannelNumber]};
+    audio20_control_cur_1_t mute1 = {.bCur = audio_get_mute(request->bChannelNumber)};
     TU_LOG1("Get channel %u mute %d\r\n", request->bChannelNumber, mute1.bCur);
     return tud_audio_buffer_and_schedule_control_xfer(rhport, (tusb_control_request_t const *) request, &mute1, sizeof(mute1));
   } else if (request->bControlSelector == AUDIO20_FU_CTRL_VOLUME) {
     if (request->bRequest == AUDIO20_CS_REQ_RANGE) {
+      int16_t min, max, res;
+      audio_get_volume_range_db_256(&min, &max, &res);
       audio20_control_range_2_n_t(1) range_vol = {
           .wNumSubRanges = tu_htole16(1),
-          .subrange[0] = {.bMin = tu_htole16(-VOLUME_CTRL_50_DB), tu_htole16(VOLUME_CTRL_0_DB), tu_htole16(256)}};
+          .subrange[0] = {.bMin = tu_htole16(min), tu_htole16(max), tu_htole16(res)}};
       TU_LOG1("Get channel %u volume range (%d, %d, %u) dB\r\n", request->bChannelNumber,
               range_vol.subrange[0].bMin / 256, range_vol.subrange[0].bMax / 256, range_vol.subrange[0].bRes / 256);
       return tud_audio_buffer_and_schedule_control_xfer(rhport, (tusb_control_request_t const *) request, &range_vol, sizeof(range_vol));
     } else if (request->bRequest == AUDIO20_CS_REQ_CUR) {
-      audio20_control_cur_2_t cur_vol = {.bCur = tu_htole16(volume[request->bChannelNumber])};
+      audio20_control_cur_2_t cur_vol = {.bCur = tu_htole16(audio_get_volume_db_256(request->bChannelNumber))};
       TU_LOG1("Get channel %u volume %d dB\r\n", request->bChannelNumber, cur_vol.bCur / 256);
       return tud_audio_buffer_and_schedule_control_xfer(rhport, (tusb_control_request_t const *) request, &cur_vol, sizeof(cur_vol));
     }
@@ -366,21 +432,23 @@ static bool audio20_feature_unit_get_request(uint8_t rhport, audio20_control_req
 static bool audio20_feature_unit_set_request(audio20_control_request_t const *request, uint8_t const *buf) {
   TU_ASSERT(request->bEntityID == UAC2_ENTITY_FEATURE_UNIT);
   TU_VERIFY(request->bRequest == AUDIO20_CS_REQ_CUR);
+  TU_VERIFY(request->bChannelNumber < AUDIO_USB_CHANNEL_CNT);
 
   if (request->bControlSelector == AUDIO20_FU_CTRL_MUTE) {
     TU_VERIFY(request->wLength == sizeof(audio20_control_cur_1_t));
 
-    mute[request->bChannelNumber] = ((audio20_control_cur_1_t const *) buf)->bCur;
+    const int8_t mute = ((audio20_control_cur_1_t const *) buf)->bCur;
+    audio_set_mute(request->bChannelNumber, mute);
 
-    TU_LOG1("Set channel %d Mute: %d\r\n", request->bChannelNumber, mute[request->bChannelNumber]);
+    TU_LOG1("Set channel %d Mute: %d\r\n", request->bChannelNumber, mute);
 
     return true;
   } else if (request->bControlSelector == AUDIO20_FU_CTRL_VOLUME) {
     TU_VERIFY(request->wLength == sizeof(audio20_control_cur_2_t));
 
-    volume[request->bChannelNumber] = ((audio20_control_cur_2_t const *) buf)->bCur;
-
-    TU_LOG1("Set channel %d volume: %d dB\r\n", request->bChannelNumber, volume[request->bChannelNumber] / 256);
+    const int16_t volume = (int16_t) tu_le16toh(((audio20_control_cur_2_t const *) buf)->bCur);
+    audio_set_volume_db_256(request->bChannelNumber, volume);
+    TU_LOG1("Set channel %u volume: %d/256 dB\r\n", request->bChannelNumber, volume);
 
     return true;
   } else {
@@ -417,7 +485,7 @@ static bool audio20_set_req_entity(tusb_control_request_t const *p_request, uint
   return false;
 }
 
-#endif // TUD_OPT_HIGH_SPEED
+#endif // AUDIO_UAC2_ENABLED
 
 //--------------------------------------------------------------------+
 // Main Callback Functions
@@ -429,8 +497,11 @@ bool tud_audio_set_itf_cb(uint8_t rhport, tusb_control_request_t const *p_reques
   uint8_t const alt = tu_u16_low(tu_le16toh(p_request->wValue));
 
   TU_LOG2("Set interface %d alt %d\r\n", itf, alt);
-  if (ITF_NUM_AUDIO_STREAMING == itf && alt != 0)
+  if (ITF_NUM_AUDIO_STREAMING == itf && alt != 0) {
     blink_interval_ms = BLINK_STREAMING;
+    // the unpack kernel is switched from audio_task(), not from the USB ISR
+    usb_sample_bytes = alt_sample_bytes(alt);
+  }
 
 #if CFG_AUDIO_DEBUG
   current_alt_settings = alt;
@@ -472,7 +543,7 @@ bool tud_audio_set_req_entity_cb(uint8_t rhport, tusb_control_request_t const *p
 
   if (tud_audio_version() == 1) {
     return audio10_set_req_entity(p_request, buf);
-#if TUD_OPT_HIGH_SPEED
+#if AUDIO_UAC2_ENABLED
   } else if (tud_audio_version() == 2) {
     return audio20_set_req_entity(p_request, buf);
 #endif
@@ -487,7 +558,7 @@ bool tud_audio_get_req_entity_cb(uint8_t rhport, tusb_control_request_t const *p
 
   if (tud_audio_version() == 1) {
     return audio10_get_req_entity(rhport, p_request);
-#if TUD_OPT_HIGH_SPEED
+#if AUDIO_UAC2_ENABLED
   } else if (tud_audio_version() == 2) {
     return audio20_get_req_entity(rhport, p_request);
 #endif
@@ -508,12 +579,29 @@ bool tud_audio_set_itf_close_ep_cb(uint8_t rhport, tusb_control_request_t const
   return true;
 }
 
+#if CFG_AUDIO_FEEDBACK_DMA && !CFG_AUDIO_ASRC
+// USB frame number of the last feedback update, and the 1st SOF after an init is only the reference
+static uint32_t fb_last_frame;
+static volatile bool fb_restart = true;
+
+// starts the measurement again from the nominal rate,
+// with the SOF interrupt off, which would update the state meanwhile
+static void feedback_restart(uint32_t rate) {
+  const uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  audio_feedback_init(rate, rate / 1000 * 4);
+  tud_audio_fb_set(audio_feedback_state.value);
+  fb_restart = true;
+  __set_PRIMASK(primask);
+}
+#endif
+
 void tud_audio_feedback_params_cb(uint8_t func_id, uint8_t alt_itf, audio_feedback_params_t *feedback_param) {
   (void) func_id;
   (void) alt_itf;
-  // Set feedback method to fifo counting
-  feedback_param->method = AUDIO_FEEDBACK_METHOD_FIFO_COUNT;
-  feedback_param->sample_freq = AUDIO_SAMPLING_RATE;
+  // called again after every sampling frequency SET_CUR
+  const uint32_t rate = usb_sample_rate;
+  feedback_param->sample_freq = rate;
 
   // About FIFO threshold:
   //
@@ -523,35 +611,94 @@ void tud_audio_feedback_params_cb(uint8_t func_id, uint8_t alt_itf, audio_feedba
   // audio_task() read audio data every 1 ms,
   // we set the threshold to 4ms of audio data
   //
+#if CFG_AUDIO_ASRC
+  // the ASRC follows the host's clock, so a constant nominal rate is reported
+  feedback_param->method = AUDIO_FEEDBACK_METHOD_DISABLED;
+  tud_audio_fb_set((uint32_t)(((uint64_t)rate << 16) / 1000));
+#elif CFG_AUDIO_FEEDBACK_DMA
+  // the feedback value is set by us from tud_audio_feedback_interval_isr(), the driver only sends it
+  feedback_param->method = AUDIO_FEEDBACK_METHOD_DISABLED;
+
+  feedback_restart(rate);
+  // The class driver needs no SOF for the disabled method, but it still calls the interval ISR
+  // on every SOF when the interrupt is on. It is enabled in the DCD directly, tud_sof_cb_enable()
+  // would also queue every SOF as an event for tud_task(), which overflows the event queue
+  // whenever the main loop blocks for more than a few ms.
+  dcd_sof_enable(BOARD_TUD_RHPORT, true);
+#else
+  // Set feedback method to fifo counting
+  feedback_param->method = AUDIO_FEEDBACK_METHOD_FIFO_COUNT;
   feedback_param->fifo_count.fifo_threshold =
-		  AUDIO_SAMPLING_RATE * CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX * CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX / 1000 * 4;
+		  rate * CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX * alt_sample_bytes(alt_itf) / 1000 * 4;
+#endif
 }
 
+#if CFG_AUDIO_FEEDBACK_DMA && !CFG_AUDIO_ASRC
+// Invoked from the SOF interrupt (the feedback EP has bInterval 1, so on every SOF).
+// The I2S DMA position is sampled here against the host's clock. In the ISR the sample is taken
+// at the SOF, and not whenever tud_task() gets to it, and the USB frame number tells how many SOFs
+// it covers when an interrupt was late, so no played frame is lost or counted twice.
+void tud_audio_feedback_interval_isr(uint8_t func_id, uint32_t frame_number, uint8_t interval_shift) {
+  (void) func_id;
+  (void) interval_shift;
+
+  // 11bit frame number
+  const uint16_t sof_frames = (uint16_t)((frame_number - fb_last_frame) & 0x7FF);
+  fb_last_frame = frame_number;
+  if (fb_restart || (sof_frames == 0)) {
+    // 1st SOF after the init, only the reference position is taken
+    fb_restart = false;
+    (void) audio_get_played_frames(1);
+    return;
+  }
+
+  const uint16_t played = audio_get_played_frames(sof_frames);
+  // The refill takes a whole period from the FIFO at once, so sampled at the SOF the FIFO is a sawtooth
+  // of one period, which slowly slides against the SOF with the clock difference. The PI would chase it
+  // (a cycle of a few 100ppm, see tools/feedback_sim.c), so the played part of the current period is
+  // taken as already gone from the FIFO.
+  const int32_t buffered = (int32_t)(tud_audio_available() / AUDIO_FRAME_BYTES) - audio_get_period_pos_frames();
+  const uint16_t fifo_frames = (uint16_t)MAX(buffered, 0);
+  const bool playing = (get_audio_state() == I2S_AUDIO_STREAMING);
+
+  tud_audio_fb_set(audio_feedback_update(played, sof_frames, fifo_frames, playing));
+}
+#endif
+
 bool tud_audio_rx_done_isr(uint8_t rhport, uint16_t n_bytes_received, uint8_t func_id, uint8_t ep_out, uint8_t cur_alt_setting) {
   (void) func_id;
-  (void) cur_alt_setting;
 
   if (rhport == BOARD_TUD_RHPORT && ep_out == 1) {
     // In some rare occasions we are getting a packet which is not dividable by
-    //(2 channel * 24bit) = 2ch * 3byte = 6byte
+    //(2 channel * 24bit) = 2ch * 3byte = 6byte (or 4 / 8 bytes with the other alternate settings)
     // which then leads to de-sync on the I2S byte level and we are getting a massive noise.
     // This seems to happen when the audio device is plugged into an USB-C dock
     // which has a monitor connected to it and the PC is usually under heavy(er) load.
     // This seems to affect only that single Win 11 23H2 PC
     // but in theory it could happen with any other host, so fix:
-    const uint16_t ALIGN = CFG_TUD_AUDIO_FUNC_1_N_BYTES_PER_SAMPLE_RX * CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX;
+    const uint8_t sample_bytes = alt_sample_bytes(cur_alt_setting);
+    const uint16_t ALIGN = sample_bytes * CFG_TUD_AUDIO_FUNC_1_N_CHANNELS_RX;
     const uint16_t misalign = n_bytes_received % ALIGN;
    
     if (misalign != 0) {
       // printf("misalign: %u\n", n_bytes_received);
       HAL_GPIO_WritePin(LED_Blue_GPIO_Port, LED_Blue_Pin, GPIO_PIN_SET);
-      // actually roll BACK the write pointer by 'n_bytes_received' e.g. delete the broken data.
-      // Just deleting the last 'misalign' bytes is not enough, it is audible
-      tu_fifo_t* ep_out_ff = tud_audio_get_ep_out_ff();
-      tu_fifo_advance_write_pointer(ep_out_ff, (uint16_t)(2*ep_out_ff->depth - n_bytes_received));
+      // 24bit packets are salvaged, see audio_fifo_realign_packet()
+      audio_fifo_realign_packet(tud_audio_get_ep_out_ff(), n_bytes_received, sample_bytes);
+    }
+
+    // the next packet would not fit -> the FIFO is overwritten and the playback jumps
+    if (tud_audio_available() > CFG_TUD_AUDIO_FUNC_1_EP_OUT_SW_BUF_SZ - CFG_TUD_AUDIO_FUNC_1_EP_OUT_SZ_FS) {
+      ++audio_stream_stats.overruns;
     }
   }
 
+  // packet arrival jitter, measured by the DWT cycle counter
+  const uint32_t now = cycle_counter_get();
+  const uint32_t interval_us = (now - last_rx_cycles) / (SystemCoreClock / 1000000);
+  last_rx_cycles = now;
+  audio_preroll_packet(interval_us, tud_audio_available(), get_audio_state() == I2S_AUDIO_STREAMING);
+
 #if CFG_AUDIO_DEBUG
   fifo_count = tud_audio_available();
   // Same averaging method used in UAC2 class
@@ -565,25 +712,95 @@ bool tud_audio_rx_done_isr(uint8_t rhport, uint16_t n_bytes_received, uint8_t fu
 // AUDIO Task
 //--------------------------------------------------------------------+
 
+// the pre-roll for the next start, see audio_preroll.h
+static void update_preroll(uint32_t curr_ms) {
+  static uint32_t last_short_reads = 0;
+
+  // short reads while the host is still streaming are underruns, and not the end of the stream
+  const uint32_t short_reads = audio_stream_stats.short_reads;
+  const bool underrun = ((short_reads != last_short_reads) && (blink_interval_ms == BLINK_STREAMING)
+      && (get_audio_state() == I2S_AUDIO_STREAMING)) || starved;
+  last_short_reads = short_reads;
+  starved = false;
+
+  audio_preroll_update(curr_ms, underrun, AUDIO_PACKET_LEN);
+}
+
+// switches the I2S and the DSP to the rate and the sample format the host selected, after the fade out of the old one
+// returns true while the switch is pending (no playback may start)
+static bool apply_stream_format(void) {
+  const uint32_t rate = usb_sample_rate;
+  const uint8_t bytes = usb_sample_bytes;
+  if ((rate == audio_get_sample_rate()) && (bytes == audio_get_sample_bytes())) {
+    return false;
+  }
+
+  // the FIFO may have the new format already, so the fade out (also a running one) does not read it
+  if (get_audio_state() != I2S_AUDIO_STOPPED) {
+    audio_stop_concealed();
+    return true;
+  }
+
+  if (bytes != audio_get_sample_bytes()) {
+    // the new kernel starts on a whole frame of the new format, with the USB ISR off meanwhile
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    tud_audio_clear_ep_out_ff();
+    __set_PRIMASK(primask);
+
+    if (!audio_set_sample_bytes(bytes)) {
+      usb_sample_bytes = audio_get_sample_bytes();
+    }
+  }
+  if (rate == audio_get_sample_rate()) {
+    return false;
+  }
+
+  if (!audio_set_sample_rate(rate)) {
+    // the table has every advertised rate, so only a HAL error can get here, do not retry forever
+    usb_sample_rate = audio_get_sample_rate();
+    return false;
+  }
+  audio_pipeline_set_sample_rate(rate);
+  audio_controls_sample_rate_changed();
+
+#if CFG_AUDIO_FEEDBACK_DMA && !CFG_AUDIO_ASRC
+  // the I2S was stopped, start the measurement again from the new nominal rate
+  feedback_restart(rate);
+#endif
+  return false;
+}
+
 void audio_task(void) {
   static uint32_t last_ms = 0;
   uint32_t curr_ms = HAL_GetTick();
   if (last_ms == curr_ms) return; // not enough time
   last_ms = curr_ms;
 
+  update_preroll(curr_ms);
+
+  if (apply_stream_format()) {
+    return;
+  }
 
   const uint16_t available = tud_audio_available();
 
   if (blink_interval_ms == BLINK_STREAMING) {
-	  // start audio only when the stream is active
-	  if ((available >= 4*AUDIO_PACKET_LEN) && (get_audio_state() == I2S_AUDIO_STOPPED)) {
+	  // start audio only when the stream is active (a fade out which is still running is turned around)
+	  if ((available >= preroll_stats.preroll * AUDIO_PACKET_LEN) && (get_audio_state() != I2S_AUDIO_STREAMING)) {
+		  audio_preroll_started();
 		  audio_play();
 	  }
   }
 
   // stop when data actually stop
   if ((available < AUDIO_PACKET_LEN) && (get_audio_state() == I2S_AUDIO_STREAMING)) {
+	  // with the alternate setting still active it is a dropout, the pre-roll was too small
+	  starved = (blink_interval_ms == BLINK_STREAMING);
 	  audio_stop();
+#if CFG_AUDIO_BENCHMARK
+	  audio_pipeline_print_stats();
+#endif
   }
 }
 
@@ -614,13 +831,22 @@ void audio_debug_task(void) {
   start_ms = curr_ms;
 
   audio_debug_info_t debug_info;
-  debug_info.sample_rate = AUDIO_SAMPLING_RATE;
+  debug_info.sample_rate = audio_get_sample_rate();
   debug_info.alt_settings = current_alt_settings;
   debug_info.fifo_size = CFG_TUD_AUDIO_FUNC_1_EP_OUT_SW_BUF_SZ;
   debug_info.fifo_count = fifo_count;
   debug_info.fifo_count_avg = (uint16_t) (fifo_count_avg >> 16);
-  debug_info.mute = audio_get_mute();
-  debug_info.volume = audio_get_volume_usb_pct();
+  debug_info.mute = audio_get_mute(0);
+  debug_info.volume = audio_get_volume_usb_pct(0);
+  debug_info.short_reads = audio_stream_stats.short_reads;
+  debug_info.overruns = audio_stream_stats.overruns;
+#if CFG_AUDIO_LIMITER
+  debug_info.limiter_reduction = audio_limiter_get_reduction_db_x10();
+  debug_info.codec_clips = (uint16_t)audio_limiter_stats.codec_clips;
+#else
+  debug_info.limiter_reduction = 0;
+  debug_info.codec_clips = 0;
+#endif
 
   if (tud_hid_ready())
     tud_hid_report(0, &debug_info, sizeof(debug_info));
@@ -0,0 +1,132 @@
+// Host benchmark of the ASRC core (project/Core/Src/audio_asrc.c)
+// Reports the speed and the THD+N of a 1kHz sine at the typical +-500ppm ratios.
+//
+// build & run:
+//   gcc -O2 -I../project/Core/Inc asrc_bench.c ../project/Core/Src/audio_asrc.c -lm -o asrc_bench && ./asrc_bench
+//
+// On the target the cycles are measured by audio_asrc_benchmark() (CFG_AUDIO_BENCHMARK)
+
+#include "audio_asrc.h"
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#define FS          48000.0
+#define TONE_HZ     1000.0
+#define AMPL        0.891 // -1dBFS
+#define SECONDS     4
+#define OUT_FRAMES  (48000 * SECONDS)
+#define PERIOD      48    // 1ms refill, like in the firmware
+#define SKIP        4800  // settle time of the history, not used in the fit
+
+static int32_t out[2 * OUT_FRAMES];
+
+// least squares fit of DC + sine + cosine at the known frequency, THD+N is what is left
+static double thd_n_db(const int32_t *x, int n, double w) {
+	double ss = 0, sc = 0, cc = 0, s1 = 0, c1 = 0, ys = 0, yc = 0, y1 = 0;
+	for (int i = 0; i < n; ++i) {
+		const double s = sin(w * i), c = cos(w * i), y = x[2 * i] / 2147483648.0;
+		ss += s * s; sc += s * c; cc += c * c; s1 += s; c1 += c;
+		ys += y * s; yc += y * c; y1 += y;
+	}
+
+	// 3x3 normal equations by Cramer's rule
+	const double m[3][3] = { { ss, sc, s1 }, { sc, cc, c1 }, { s1, c1, n } };
+	const double r[3] = { ys, yc, y1 };
+	double k[3];
+	const double det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+			- m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+			+ m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+	for (int j = 0; j < 3; ++j) {
+		double t[3][3];
+		for (int a = 0; a < 3; ++a) {
+			for (int b = 0; b < 3; ++b) {
+				t[a][b] = (b == j) ? r[a] : m[a][b];
+			}
+		}
+		k[j] = (t[0][0] * (t[1][1] * t[2][2] - t[1][2] * t[2][1])
+				- t[0][1] * (t[1][0] * t[2][2] - t[1][2] * t[2][0])
+				+ t[0][2] * (t[1][0] * t[2][1] - t[1][1] * t[2][0])) / det;
+	}
+
+	double sig = 0, res = 0;
+	for (int i = 0; i < n; ++i) {
+		const double f = k[0] * sin(w * i) + k[1] * cos(w * i) + k[2];
+		const double e = x[2 * i] / 2147483648.0 - f;
+		sig += f * f;
+		res += e * e;
+	}
+	return 10 * log10(res / sig);
+}
+
+static void run(int ppm) {
+	static int32_t in[2 * (PERIOD + 16)];
+	AudioAsrc st;
+	audio_asrc_init(&st, 0);
+	st.ratio_adj = ppm * 4295;
+
+	// the source is generated on the fly, 'src_pos' is the next frame to append
+	long src_pos = 0;
+	uint16_t in_frames = 0;
+	int produced = 0;
+	double secs = 0;
+#ifdef HAVE_TSC
+	unsigned long long cycles = 0;
+#endif
+
+	while (produced < OUT_FRAMES) {
+		const uint16_t need = audio_asrc_needed(&st, PERIOD);
+		while (in_frames < need) {
+			const double v = AMPL * sin(2 * M_PI * TONE_HZ / FS * src_pos++);
+			const int32_t s = (int32_t)lrint(v * 8388607.0) * 256;
+			in[2 * in_frames + 0] = s;
+			in[2 * in_frames + 1] = s;
+			++in_frames;
+		}
+
+		uint16_t consumed;
+		struct timespec t0, t1;
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+#ifdef HAVE_TSC
+		const unsigned long long c0 = __rdtsc();
+#endif
+		const uint16_t n = audio_asrc_process(&st, in, in_frames, &out[2 * produced], PERIOD, &consumed);
+#ifdef HAVE_TSC
+		cycles += __rdtsc() - c0;
+#endif
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		secs += (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+		for (uint16_t i = consumed; i < in_frames; ++i) {
+			in[2 * (i - consumed) + 0] = in[2 * i + 0];
+			in[2 * (i - consumed) + 1] = in[2 * i + 1];
+		}
+		in_frames -= consumed;
+		produced += n;
+	}
+
+	// the output reads the source (1 + ppm) faster, so the tone is that much higher
+	const double w = 2 * M_PI * TONE_HZ / FS * (1.0 + ppm * 1e-6);
+	const double thdn = thd_n_db(&out[2 * SKIP], OUT_FRAMES - SKIP, w);
+	const double ns = secs * 1e9 / (2.0 * OUT_FRAMES);
+
+#ifdef HAVE_TSC
+	printf("%+5d ppm: %6.2f ns/sample, %6.1f TSC cycles/sample, THD+N %6.1f dB\n",
+			ppm, ns, (double)cycles / (2.0 * OUT_FRAMES), thdn);
+#else
+	printf("%+5d ppm: %6.2f ns/sample, THD+N %6.1f dB\n", ppm, ns, thdn);
+#endif
+}
+
+int main(void) {
+	const int ppms[] = { -500, -100, 0, 100, 500 };
+	for (unsigned i = 0; i < sizeof(ppms) / sizeof(ppms[0]); ++i) {
+		run(ppms[i]);
+	}
+	return 0;
+}
@@ -0,0 +1,56 @@
+# Biquad design shared by the table generators, the same as the firmware does it at run time:
+# RBJ audio EQ cookbook (audio_eq_calc_biquad() in audio_eq.c)
+# and the Q31 conversion (audio_biquad_to_q31() in audio_biquad.c)
+
+import math
+
+PEAK, LOW_SHELF, HIGH_SHELF, HIGH_PASS, LOW_PASS = range(5)
+
+
+def rbj(kind, freq, gain_db, q, fs):
+    """normalized (a0 = 1) coefficients: b0, b1, b2, a1, a2"""
+    w0 = 2 * math.pi * freq / fs
+    cw = math.cos(w0)
+    alpha = math.sin(w0) / (2 * q)
+    A = 10 ** (gain_db / 40)
+    sa = 2 * math.sqrt(A) * alpha
+
+    if kind == LOW_SHELF:
+        b = (A * ((A + 1) - (A - 1) * cw + sa), 2 * A * ((A - 1) - (A + 1) * cw), A * ((A + 1) - (A - 1) * cw - sa))
+        a = ((A + 1) + (A - 1) * cw + sa, -2 * ((A - 1) + (A + 1) * cw), (A + 1) + (A - 1) * cw - sa)
+    elif kind == HIGH_SHELF:
+        b = (A * ((A + 1) + (A - 1) * cw + sa), -2 * A * ((A - 1) + (A + 1) * cw), A * ((A + 1) + (A - 1) * cw - sa))
+        a = ((A + 1) - (A - 1) * cw + sa, 2 * ((A - 1) - (A + 1) * cw), (A + 1) - (A - 1) * cw - sa)
+    elif kind == HIGH_PASS:
+        b = ((1 + cw) / 2, -(1 + cw), (1 + cw) / 2)
+        a = (1 + alpha, -2 * cw, 1 - alpha)
+    elif kind == LOW_PASS:
+        b = ((1 - cw) / 2, 1 - cw, (1 - cw) / 2)
+        a = (1 + alpha, -2 * cw, 1 - alpha)
+    else:
+        b = (1 + alpha * A, -2 * cw, 1 - alpha * A)
+        a = (1 + alpha / A, -2 * cw, 1 - alpha / A)
+
+    return (b[0] / a[0], b[1] / a[0], b[2] / a[0], a[1] / a[0], a[2] / a[0])
+
+
+def scale(c, gain):
+    """multiplies the numerator, the gain of the whole filter"""
+    return (c[0] * gain, c[1] * gain, c[2] * gain, c[3], c[4])
+
+
+def to_q31(c):
+    """AudioBiquadQ31Coef: b0, b1, b2, -a1, -a2 scaled by 2^-shift, and the shift"""
+    v = (c[0], c[1], c[2], -c[3], -c[4])
+    m = max(abs(x) for x in v)
+    shift = 0
+    while shift < 7 and m >= (1 << shift):
+        shift += 1
+    q = [min(int(round(x * 2 ** 31 / (1 << shift))), 2 ** 31 - 1) for x in v]
+    return q, shift
+
+
+def q31_initializer(c):
+    """C initializer of an AudioBiquadQ31Coef"""
+    q, shift = to_q31(c)
+    return "{ " + ", ".join(f"{x:11d}" for x in q) + f", {shift} }}"
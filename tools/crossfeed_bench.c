@@ -0,0 +1,177 @@
+// Host frequency response check and benchmark of the headphone crossfeed (project/Core/Src/audio_crossfeed.c)
+//
+// build & run:
+//   gcc -O2 -I../project/Core/Inc -o crossfeed_bench crossfeed_bench.c ../project/Core/Src/audio_crossfeed.c
+//       ../project/Core/Src/audio_eq.c ../project/Core/Src/audio_biquad.c ../project/Core/Src/audio_params.c -lm
+//
+// On the target the cycles are measured by audio_crossfeed_benchmark() (CFG_AUDIO_BENCHMARK)
+
+#include "audio_crossfeed.h"
+#include "audio_eq.h"
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#define FS          48000
+#define PERIOD      48 // 1ms refill, like in the firmware
+
+// the stage is enabled by the pipeline on the target, here it is only called directly
+void audio_pipeline_enable(AudioStage *stage, bool enable) {
+	stage->enable_req = enable;
+}
+
+// |H| of the direct and the cross path and of their sum (mono) from the (float) design
+static void expected_db(AudioCrossfeedPreset preset, double f, double *direct_db, double *cross_db, double *mono_db) {
+	const AudioCrossfeedParams *p = &audio_crossfeed_presets[preset];
+	const double cross_gain = pow(10.0, -p->feed_db / 20.0);
+	const double feed = cross_gain / (1.0 + cross_gain);
+
+	const AudioEqBand band = { .enabled = true, .type = AUDIO_EQ_LOW_PASS, .freq = p->cutoff, .q = 0.5f };
+	AudioBiquad c;
+	audio_eq_calc_biquad(&band, FS, &c);
+
+	const double complex z1 = cexp(-I * 2 * M_PI * f / FS);
+	const double complex lp = (c.b0 + c.b1 * z1 + c.b2 * z1 * z1) / (1 + c.a1 * z1 + c.a2 * z1 * z1);
+
+	// the linear interpolation of the fractional delay is a (mild) low pass too
+	const double delay = p->delay_us * FS / 1e6;
+	const double frac = delay - floor(delay);
+	const double complex interp = (1 - frac) + frac * z1;
+	const double complex delayed = interp * cpow(z1, floor(delay));
+
+	const double complex direct = 1 - feed * lp;
+	const double complex cross = feed * lp * delayed;
+	*direct_db = 20 * log10(cabs(direct));
+	*cross_db = 20 * log10(cabs(cross));
+	*mono_db = 20 * log10(cabs(direct + cross));
+}
+
+// a sine on the left input only, the gain to the left (direct) and the right (cross) output
+static void measured_db(AudioCrossfeedPreset preset, double f, double *direct_db, double *cross_db) {
+	static int32_t buf[2 * PERIOD];
+	const int periods = 1000;
+	double in_pow = 0, l_pow = 0, r_pow = 0;
+	long n = 0;
+
+	audio_crossfeed_init(FS);
+	audio_crossfeed_set_preset(preset);
+
+	for (int p = 0; p < periods; ++p) {
+		for (int i = 0; i < PERIOD; ++i, ++n) {
+			buf[2 * i + 0] = (int32_t)(0.5 * 2147483648.0 * sin(2 * M_PI * f * n / FS));
+			buf[2 * i + 1] = 0;
+			if (p >= periods / 2) {
+				in_pow += (double)buf[2 * i] * buf[2 * i];
+			}
+		}
+		audio_crossfeed_process(buf, PERIOD);
+		if (p >= periods / 2) {
+			for (int i = 0; i < PERIOD; ++i) {
+				l_pow += (double)buf[2 * i + 0] * buf[2 * i + 0];
+				r_pow += (double)buf[2 * i + 1] * buf[2 * i + 1];
+			}
+		}
+	}
+
+	*direct_db = 10 * log10(l_pow / in_pow);
+	*cross_db = 10 * log10(r_pow / in_pow);
+}
+
+// the same signal on both inputs (mono)
+static double mono_db(AudioCrossfeedPreset preset, double f) {
+	static int32_t buf[2 * PERIOD];
+	const int periods = 1000;
+	double in_pow = 0, out_pow = 0;
+	long n = 0;
+
+	audio_crossfeed_init(FS);
+	audio_crossfeed_set_preset(preset);
+
+	for (int p = 0; p < periods; ++p) {
+		for (int i = 0; i < PERIOD; ++i, ++n) {
+			buf[2 * i + 0] = buf[2 * i + 1] = (int32_t)(0.5 * 2147483648.0 * sin(2 * M_PI * f * n / FS));
+			if (p >= periods / 2) {
+				in_pow += (double)buf[2 * i] * buf[2 * i];
+			}
+		}
+		audio_crossfeed_process(buf, PERIOD);
+		if (p >= periods / 2) {
+			for (int i = 0; i < PERIOD; ++i) {
+				out_pow += (double)buf[2 * i] * buf[2 * i];
+			}
+		}
+	}
+	return 10 * log10(out_pow / in_pow);
+}
+
+static void bench(void) {
+	static int32_t buf[2 * PERIOD];
+	const int periods = 20000;
+
+	audio_crossfeed_init(FS);
+	audio_crossfeed_set_preset(AUDIO_CROSSFEED_BS2B);
+
+	double secs = 0;
+#ifdef HAVE_TSC
+	unsigned long long cycles = 0;
+#endif
+	for (int p = 0; p < periods; ++p) {
+		for (int i = 0; i < 2 * PERIOD; ++i) {
+			buf[i] = (int32_t)((short)(i * 1237 + p)) << 16;
+		}
+		struct timespec t0, t1;
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+#ifdef HAVE_TSC
+		const unsigned long long c0 = __rdtsc();
+#endif
+		audio_crossfeed_process(buf, PERIOD);
+#ifdef HAVE_TSC
+		cycles += __rdtsc() - c0;
+#endif
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		secs += (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+	}
+
+	const double samples = 2.0 * PERIOD * periods;
+#ifdef HAVE_TSC
+	printf("crossfeed: %6.2f ns/sample, %6.1f TSC cycles/sample\n", secs * 1e9 / samples, cycles / samples);
+#else
+	printf("crossfeed: %6.2f ns/sample\n", secs * 1e9 / samples);
+#endif
+}
+
+// the mono response may only ripple this much around 0dB: the direct path is x - lp(x), so it is flat
+// at low and high frequencies, only around the cutoff the delay of the cross path moves it (bs2b -2.2dB at 500Hz)
+#define MONO_MAX_DB    2.5
+
+int main(void) {
+	static const double freqs[] = { 50, 100, 200, 500, 700, 1000, 2000, 5000, 10000, 16000 };
+	double max_err = 0;
+	double max_mono = 0;
+
+	for (int preset = AUDIO_CROSSFEED_MEIER; preset < AUDIO_CROSSFEED_PRESET_CNT; ++preset) {
+		printf("%s         direct             cross              mono\n", audio_crossfeed_presets[preset].name);
+		printf("   freq   expected measured   expected measured   expected measured\n");
+		for (unsigned i = 0; i < sizeof(freqs) / sizeof(freqs[0]); ++i) {
+			double ed, ec, em, md, mc;
+			expected_db(preset, freqs[i], &ed, &ec, &em);
+			measured_db(preset, freqs[i], &md, &mc);
+			const double mm = mono_db(preset, freqs[i]);
+			printf("%7.0f %8.2f %8.2f   %8.2f %8.2f   %8.2f %8.2f dB\n", freqs[i], ed, md, ec, mc, em, mm);
+			max_err = fmax(max_err, fmax(fabs(ed - md), fmax(fabs(ec - mc), fabs(em - mm))));
+			max_mono = fmax(max_mono, fabs(mm));
+		}
+		printf("\n");
+	}
+	printf("max deviation %.3f dB, max mono level change %.3f dB (limit %.2f dB)\n\n", max_err, max_mono, MONO_MAX_DB);
+
+	bench();
+
+	return ((max_err < 0.1) && (max_mono < MONO_MAX_DB)) ? 0 : 1;
+}
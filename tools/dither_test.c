@@ -0,0 +1,151 @@
+// Host noise spectrum test of the requantization to 24bit (project/Core/Src/audio_dither.c)
+//
+// A -130dBFS (~2.5 LSB) 1kHz sine in Q31 is requantized by the plain truncation (the pack
+// without the dither stage), by rounding, by TPDF dither and by the noise shaped TPDF dither.
+// The spectrum shows the harmonics of the truncation, and the flat (or shaped) noise of the dither.
+//
+// build & run:
+//   gcc -O2 -I../project/Core/Inc -o dither_test dither_test.c ../project/Core/Src/audio_dither.c -lm && ./dither_test
+
+#include "audio_dither.h"
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FS          48000
+#define PERIOD      48 // 1ms refill, like in the firmware
+#define N           65536
+#define SINE_HZ     1000.0
+#define SINE_DBFS   -130.0
+
+static void fft(double complex *x, int n) {
+	for (int i = 1, j = 0; i < n; ++i) {
+		int bit = n >> 1;
+		for (; j & bit; bit >>= 1) {
+			j ^= bit;
+		}
+		j ^= bit;
+		if (i < j) {
+			const double complex t = x[i];
+			x[i] = x[j];
+			x[j] = t;
+		}
+	}
+	for (int len = 2; len <= n; len <<= 1) {
+		const double complex w = cexp(-2 * I * M_PI / len);
+		for (int i = 0; i < n; i += len) {
+			double complex wk = 1;
+			for (int k = 0; k < len / 2; ++k) {
+				const double complex u = x[i + k];
+				const double complex v = x[i + k + len / 2] * wk;
+				x[i + k] = u + v;
+				x[i + k + len / 2] = u - v;
+				wk *= w;
+			}
+		}
+	}
+}
+
+typedef struct {
+	double spur_db;      // the largest component outside of the fundamental, dBFS
+	double noise_lo_db;  // noise density 20Hz - 4kHz, dBFS per bin
+	double noise_hi_db;  // noise density 16kHz - 24kHz, dBFS per bin
+} Spectrum;
+
+static Spectrum analyze(const int32_t *left) {
+	static double complex x[N];
+	static double p[N / 2];
+	double wsum = 0;
+
+	for (int i = 0; i < N; ++i) {
+		const double w = 0.5 - 0.5 * cos(2 * M_PI * i / N); // Hann
+		x[i] = w * left[i] / 2147483648.0;
+		wsum += w;
+	}
+	fft(x, N);
+	for (int k = 0; k < N / 2; ++k) {
+		// full scale sine = 0dBFS
+		p[k] = pow(2 * cabs(x[k]) / wsum, 2);
+	}
+
+	const int fund = (int)lround(SINE_HZ * N / FS);
+	Spectrum s = { -400, 0, 0 };
+	double lo = 0, hi = 0;
+	int lo_n = 0, hi_n = 0;
+	for (int k = 2; k < N / 2; ++k) {
+		const double f = (double)k * FS / N;
+		if (abs(k - fund) > 3) {
+			s.spur_db = fmax(s.spur_db, 10 * log10(p[k] + 1e-40));
+		}
+		if ((f >= 20) && (f < 4000) && (abs(k - fund) > 3)) {
+			lo += p[k];
+			++lo_n;
+		}
+		if (f >= 16000) {
+			hi += p[k];
+			++hi_n;
+		}
+	}
+	s.noise_lo_db = 10 * log10(lo / lo_n);
+	s.noise_hi_db = 10 * log10(hi / hi_n);
+	return s;
+}
+
+static void make_sine(int32_t *buf) {
+	const double amp = pow(10, SINE_DBFS / 20) * 2147483648.0;
+	for (int i = 0; i < N; ++i) {
+		// the same on both channels, only the left one is analyzed
+		buf[2 * i + 0] = buf[2 * i + 1] = (int32_t)lround(amp * sin(2 * M_PI * SINE_HZ * i / FS));
+	}
+}
+
+static Spectrum run(int mode) {
+	static int32_t buf[2 * N];
+	static int32_t left[N];
+
+	make_sine(buf);
+	if (mode < 0) {
+		// the pack alone, truncation
+		for (int i = 0; i < 2 * N; ++i) {
+			buf[i] &= ~0xFF;
+		}
+	} else {
+		audio_dither_init(mode);
+		for (int i = 0; i < N; i += PERIOD) {
+			audio_dither_process(&buf[2 * i], (N - i < PERIOD) ? N - i : PERIOD);
+		}
+	}
+
+	for (int i = 0; i < N; ++i) {
+		left[i] = buf[2 * i];
+		if (left[i] & 0xFF) {
+			printf("not 24bit at %d\n", i);
+		}
+	}
+	return analyze(left);
+}
+
+int main(void) {
+	static const char *const names[] = { "truncation", "rounding", "TPDF", "TPDF shaped" };
+
+	printf("%.0fdBFS %.0fHz sine, %d point FFT\n", SINE_DBFS, SINE_HZ, N);
+	printf("                max spur   noise <4kHz  noise >16kHz (dBFS/bin)\n");
+
+	Spectrum s[4];
+	for (int m = -1; m <= AUDIO_DITHER_SHAPED; ++m) {
+		s[m + 1] = run(m);
+		printf("%-12s %9.1f %12.1f %12.1f\n", names[m + 1], s[m + 1].spur_db, s[m + 1].noise_lo_db, s[m + 1].noise_hi_db);
+	}
+
+	// the dither has to turn the harmonics into noise: the spurs are only a bit above the noise floor,
+	// and the shaping has to lower the noise in the low band
+	const int ok = (s[2].spur_db < s[0].spur_db - 20)
+			&& (s[2].spur_db < s[2].noise_lo_db + 15)
+			&& (s[3].noise_lo_db < s[2].noise_lo_db - 6)
+			&& (s[3].noise_hi_db > s[2].noise_hi_db);
+	printf("%s\n", ok ? "OK" : "FAIL");
+
+	return ok ? 0 : 1;
+}
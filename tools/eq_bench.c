@@ -0,0 +1,224 @@
+// Host benchmark and frequency response check of the parametric EQ (project/Core/Src/audio_eq.c)
+// and bit exactness check of the block biquad kernel against the reference (project/Core/Src/audio_biquad.c).
+// The host build runs the plain C fallback of the kernel, the SMLAL inline asm is only compared on the target
+// by audio_biquad_benchmark() (CFG_AUDIO_BENCHMARK).
+//
+// build & run:
+//   gcc -O2 -DCFG_AUDIO_EQ_BANDS=10 -I../project/Core/Inc -o eq_bench eq_bench.c
+//       ../project/Core/Src/audio_eq.c ../project/Core/Src/audio_biquad.c ../project/Core/Src/audio_params.c -lm
+//   ./eq_bench
+//
+// On the target the cycles are measured by audio_eq_benchmark() (CFG_AUDIO_BENCHMARK)
+
+#include "audio_eq.h"
+#include "audio_common.h"
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#define FS          48000
+#define PERIOD      48 // 1ms refill, like in the firmware
+
+static const AudioEqBand test_bands[] = {
+	{ true, AUDIO_EQ_HIGH_PASS,  30.0f,   0.0f, 0.707f },
+	{ true, AUDIO_EQ_LOW_SHELF,  100.0f,  4.0f, 0.707f },
+	{ true, AUDIO_EQ_PEAK,       1000.0f, 6.0f, 1.0f },
+	{ true, AUDIO_EQ_PEAK,       3500.0f, -4.5f, 2.0f },
+	{ true, AUDIO_EQ_HIGH_SHELF, 8000.0f, -3.0f, 0.707f },
+	{ true, AUDIO_EQ_LOW_PASS,   18000.0f, 0.0f, 0.707f },
+};
+#define TEST_BANDS (sizeof(test_bands) / sizeof(test_bands[0]))
+
+// |H| of the cascade from the (float) coefficients
+static double expected_db(double f) {
+	const double complex z1 = cexp(-I * 2 * M_PI * f / FS);
+	double complex h = 1;
+	for (unsigned b = 0; b < TEST_BANDS; ++b) {
+		AudioBiquad c;
+		audio_eq_calc_biquad(&test_bands[b], FS, &c);
+		h *= (c.b0 + c.b1 * z1 + c.b2 * z1 * z1) / (1 + c.a1 * z1 + c.a2 * z1 * z1);
+	}
+	return 20 * log10(cabs(h));
+}
+
+// runs a sine through the EQ and measures the gain after it settled
+static double measured_db(double f) {
+	static int32_t buf[2 * PERIOD];
+	const int periods = 1000;
+	double in_pow = 0, out_pow = 0;
+	long n = 0;
+
+	audio_eq_init(FS);
+	for (unsigned b = 0; b < TEST_BANDS; ++b) {
+		audio_eq_set_band(b, &test_bands[b]);
+	}
+
+	for (int p = 0; p < periods; ++p) {
+		for (int i = 0; i < PERIOD; ++i, ++n) {
+			buf[2 * i + 0] = buf[2 * i + 1] = (int32_t)(0.25 * 2147483648.0 * sin(2 * M_PI * f * n / FS));
+		}
+		if (p >= periods / 2) {
+			for (int i = 0; i < 2 * PERIOD; ++i) {
+				in_pow += (double)buf[i] * buf[i];
+			}
+		}
+		audio_eq_process(buf, PERIOD);
+		if (p >= periods / 2) {
+			for (int i = 0; i < 2 * PERIOD; ++i) {
+				out_pow += (double)buf[i] * buf[i];
+			}
+		}
+	}
+	return 10 * log10(out_pow / in_pow);
+}
+
+static void bench(int bands) {
+	static int32_t buf[2 * PERIOD];
+	const int periods = 20000;
+	const AudioEqBand peak = { true, AUDIO_EQ_PEAK, 1000.0f, 3.0f, 1.0f };
+
+	audio_eq_init(FS);
+	for (int b = 0; b < bands; ++b) {
+		audio_eq_set_band(b, &peak);
+	}
+
+	double secs = 0;
+#ifdef HAVE_TSC
+	unsigned long long cycles = 0;
+#endif
+	for (int p = 0; p < periods; ++p) {
+		for (int i = 0; i < 2 * PERIOD; ++i) {
+			buf[i] = (int32_t)((short)(i * 1237 + p)) << 16;
+		}
+		struct timespec t0, t1;
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+#ifdef HAVE_TSC
+		const unsigned long long c0 = __rdtsc();
+#endif
+		audio_eq_process(buf, PERIOD);
+#ifdef HAVE_TSC
+		cycles += __rdtsc() - c0;
+#endif
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		secs += (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+	}
+
+	const double samples = 2.0 * PERIOD * periods;
+#ifdef HAVE_TSC
+	printf("%2d bands: %6.2f ns/sample, %6.1f TSC cycles/sample\n", bands, secs * 1e9 / samples, cycles / samples);
+#else
+	printf("%2d bands: %6.2f ns/sample\n", bands, secs * 1e9 / samples);
+#endif
+}
+
+// random 24bit input, including full scale, through the cascade of the test bands
+static int bit_exact(void) {
+	static int32_t buf_ref[2 * PERIOD];
+	static int32_t buf[2 * PERIOD];
+	AudioBiquadQ31 st_ref[TEST_BANDS];
+	AudioBiquadQ31 st[TEST_BANDS];
+	const int periods = 10000;
+
+	memset(st_ref, 0, sizeof(st_ref));
+	for (unsigned b = 0; b < TEST_BANDS; ++b) {
+		AudioBiquad c;
+		audio_eq_calc_biquad(&test_bands[b], FS, &c);
+		audio_biquad_to_q31(&c, &st_ref[b].coef);
+	}
+	memcpy(st, st_ref, sizeof(st));
+
+	srand(1);
+	for (int p = 0; p < periods; ++p) {
+		for (int i = 0; i < 2 * PERIOD; ++i) {
+			// every 16th period is square-ish full scale, so the saturation is hit too
+			const int32_t v = (p & 15) ? ((rand() & 0xFFFFFF) - 0x800000) : ((i & 8) ? 0x7FFFFF : -0x800000);
+			buf_ref[i] = buf[i] = (int32_t)((uint32_t)v << 8);
+		}
+		audio_biquad_cascade_ref(buf_ref, PERIOD, st_ref, TEST_BANDS);
+		audio_biquad_cascade(buf, PERIOD, st, TEST_BANDS);
+		if (memcmp(buf_ref, buf, sizeof(buf)) != 0) {
+			printf("biquad kernel MISMATCH in period %d\n", p);
+			return 0;
+		}
+	}
+	printf("biquad kernel: %d periods bit exact (C fallback, the SMLAL asm is checked on target by audio_biquad_benchmark())\n\n", periods);
+	return 1;
+}
+
+// a large change (high pass 20Hz -> 300Hz) under a 100Hz sine: a click is broadband, so everything above
+// 4kHz (4th order high pass on the output) is compared to the energy of the sine
+static int large_change(void) {
+	static int32_t buf[2 * PERIOD];
+	const double f = 100, amp = 0.1 * 2147483648.0;
+	AudioEqBand band = { true, AUDIO_EQ_HIGH_PASS, 20.0f, 0.0f, 0.707f };
+	const AudioEqBand hp_band = { true, AUDIO_EQ_HIGH_PASS, 4000.0f, 0.0f, 0.707f };
+	AudioBiquad hp;
+	double s1[2] = { 0 }, s2[2] = { 0 };
+	double click = 0, sine = 0;
+	long n = 0;
+
+	audio_eq_calc_biquad(&hp_band, FS, &hp);
+	audio_eq_init(FS);
+	audio_eq_set_band(0, &band);
+	for (int p = 0; p < 300; ++p) {
+		if (p == 200) {
+			band.freq = 300.0f;
+			audio_eq_set_band(0, &band);
+		}
+		for (int i = 0; i < PERIOD; ++i, ++n) {
+			buf[2 * i + 0] = buf[2 * i + 1] = (int32_t)(amp * sin(2 * M_PI * f * n / FS));
+		}
+		audio_eq_process(buf, PERIOD);
+		for (int i = 0; i < PERIOD; ++i) {
+			double x = buf[2 * i];
+			if (p >= 150) {
+				sine += x * x;
+			}
+			for (int k = 0; k < 2; ++k) {
+				const double y = hp.b0 * x + s1[k];
+				s1[k] = hp.b1 * x - hp.a1 * y + s2[k];
+				s2[k] = hp.b2 * x - hp.a2 * y;
+				x = y;
+			}
+			if (p >= 150) {
+				click += x * x;
+			}
+		}
+	}
+
+	const double db = 10 * log10(click / sine);
+	printf("large change: %.1f dB above 4kHz\n\n", db);
+	return db < -95;
+}
+
+int main(void) {
+	static const double freqs[] = { 20, 30, 50, 100, 200, 500, 1000, 2000, 3500, 5000, 8000, 12000, 16000, 18000, 20000 };
+	double max_err = 0;
+
+	const int exact = bit_exact();
+	// without the crossfade the coefficients are just swapped, only informative then
+	const int smooth = large_change() || (CFG_AUDIO_EQ_XFADE_BLOCKS == 0);
+
+	printf("   freq   expected   measured\n");
+	for (unsigned i = 0; i < sizeof(freqs) / sizeof(freqs[0]); ++i) {
+		const double e = expected_db(freqs[i]);
+		const double m = measured_db(freqs[i]);
+		printf("%7.0f %8.2f dB %8.2f dB\n", freqs[i], e, m);
+		max_err = fmax(max_err, fabs(e - m));
+	}
+	printf("max deviation %.3f dB\n\n", max_err);
+
+	bench(5);
+	bench(8);
+	bench(10);
+
+	return (exact && smooth && (max_err < 0.1)) ? 0 : 1;
+}
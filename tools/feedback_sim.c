@@ -0,0 +1,247 @@
+// Host simulation of the asynchronous feedback (project/Core/Src/audio_feedback.c) against a drifting I2S clock
+//
+// Every 1ms SOF the host sends the frames the feedback value asks for, the I2S plays at nominal +-ppm
+// and the DMA ring (2 periods, 88 frames = 1.995ms at 44.1kHz) is refilled from the FIFO period by period.
+// The played frames are sampled from the ring position, like from the DMA NDTR, either
+//  - in the SOF interrupt with the USB frame number difference, as the firmware does
+//    (a SOF interrupt is sometimes late by a few frames, e.g. behind a section with the IRQs off), or
+//  - from a callback deferred to the main loop, which runs late whenever the loop blocks (I2C timeouts,
+//    the OLED, printf) and then gets the queued SOFs back to back, as the old tud_sof_cb() did.
+//    It is printed for comparison only: a gap longer than the ring loses whole rings of played frames.
+// For reference the tinyUSB AUDIO_FEEDBACK_METHOD_FIFO_COUNT loop (what the firmware uses without
+// CFG_AUDIO_FEEDBACK_DMA) is run on the same clocks too. fifo_count_update() is a copy of
+// audiod_fb_fifo_count_update() (tinyusb-src/class/audio/audio_device.c) with its setup from
+// audiod_set_fb_params_freq(), it is called on every received packet with the FIFO level in bytes.
+//
+// The feedback value is checked as the host sees it, averaged over the last 1s (a single value is quantized,
+// the PI controller dithers it around the rate), the average slides by 1ms. With the firmware sampling it
+// has to settle to the real I2S rate within RATE_TOL_PPM in SETTLE_S and hold it, the FIFO has to stay
+// within 2 packets of its target (the refill takes a whole period at once) and it must never underrun.
+//
+// build & run:
+//   gcc -O2 -I../project/Core/Inc -o feedback_sim feedback_sim.c ../project/Core/Src/audio_feedback.c -lm && ./feedback_sim
+
+#include "audio_feedback.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SIM_MS          60000
+#define SETTLE_S        10
+#define RATE_TOL_PPM    30.0
+#define TARGET_MS       4       // FIFO target, like in usb_handler.c
+#define FIFO_PACKETS    12      // the USB FIFO holds 12 nominal packets
+#define QUEUE_SZ        16      // tinyUSB event queue (CFG_TUD_TASK_QUEUE_SZ)
+#define FRAME_BYTES     6       // 24bit stereo
+
+typedef enum { SAMPLE_SOF_ISR, SAMPLE_DEFERRED, FIFO_COUNT } Sampling;
+
+typedef struct {
+	uint32_t rate;
+	double ppm;
+} Case;
+
+static const Case cases[] = {
+	{ 48000, +200 }, { 48000, -200 }, { 48000, +500 }, { 48000, -500 },
+	{ 44100, +200 }, { 44100, -200 }, { 44100, +500 }, { 44100, -500 },
+};
+
+typedef struct {
+	double settle_s;        // from when the 1s average stays within RATE_TOL_PPM, at 1ms resolution
+	double max_err_ppm;     // of the 1s average after SETTLE_S
+	int32_t fifo_min;       // after SETTLE_S, relative to the target in frames
+	int32_t fifo_max;
+	uint32_t underruns;
+} Result;
+
+static double rnd(void) {
+	return rand() / (RAND_MAX + 1.0);
+}
+
+// the DMA position, and the unwrap of audio_get_played_frames() (project/Core/Src/CS43L22_driver.c)
+static uint32_t ring_frames;
+static uint32_t last_pos;
+static uint32_t nominal_rate;
+
+static uint16_t played_frames(uint64_t played_total, uint16_t elapsed_ms) {
+	const uint32_t pos = (uint32_t)(played_total % ring_frames);
+	uint32_t played = (pos + ring_frames - last_pos) % ring_frames;
+	last_pos = pos;
+
+	const uint32_t expected = nominal_rate / 100 * elapsed_ms / 10;
+	if (expected > played + ring_frames / 2) {
+		played += (expected - played + ring_frames / 2) / ring_frames * ring_frames;
+	}
+	return (uint16_t)played;
+}
+
+// the tinyUSB FIFO count feedback, in 16.16 frames per SOF and in FIFO bytes
+typedef struct {
+	uint32_t lvl_avg;
+	uint16_t lvl_thr;
+	uint32_t nom_value;
+	uint16_t rate_const[2];
+	uint32_t min_value;
+	uint32_t max_value;
+} FifoCount;
+
+static void fifo_count_init(FifoCount *fc, uint32_t sample_freq, uint16_t fifo_threshold) {
+	fc->min_value = ((sample_freq - 1) / 1000) << 16;
+	fc->max_value = (sample_freq / 1000 + 1) << 16;
+	fc->lvl_thr = fifo_threshold;
+	fc->lvl_avg = ((uint32_t)fifo_threshold) << 16;
+	fc->nom_value = ((sample_freq / 100) << 16) / (1000 / 100);
+	fc->rate_const[0] = (uint16_t)((fc->max_value - fc->nom_value) / fifo_threshold);
+	fc->rate_const[1] = (uint16_t)((fc->nom_value - fc->min_value) / fifo_threshold);
+}
+
+static uint32_t fifo_count_update(FifoCount *fc, uint16_t lvl_new) {
+	uint32_t lvl = fc->lvl_avg;
+	lvl = (uint32_t)(((uint64_t)lvl * 63 + ((uint32_t)lvl_new << 16)) >> 6);
+	fc->lvl_avg = lvl;
+
+	const uint32_t ff_lvl = lvl >> 16;
+	uint32_t feedback;
+	if (ff_lvl < fc->lvl_thr) {
+		feedback = fc->nom_value + (fc->lvl_thr - ff_lvl) * fc->rate_const[0];
+	} else {
+		feedback = fc->nom_value - (ff_lvl - fc->lvl_thr) * fc->rate_const[1];
+	}
+	feedback = (feedback > fc->max_value) ? fc->max_value : feedback;
+	feedback = (feedback < fc->min_value) ? fc->min_value : feedback;
+	return feedback;
+}
+
+static Result run(const Case *c, Sampling sampling) {
+	const double true_rate = c->rate * (1.0 + c->ppm * 1e-6);
+	const uint32_t period = c->rate / 1000;
+	const int32_t target = c->rate / 1000 * TARGET_MS;
+	const int32_t fifo_size = c->rate / 1000 * FIFO_PACKETS;
+
+	nominal_rate = c->rate;
+	ring_frames = 2 * period;
+	last_pos = 0;
+	audio_feedback_init(c->rate, (uint16_t)target);
+	FifoCount fc;
+	fifo_count_init(&fc, c->rate, (uint16_t)(target * FRAME_BYTES));
+
+	Result r = { 0, 0, INT32_MAX, INT32_MIN, 0 };
+	uint32_t fb = (sampling == FIFO_COUNT) ? fc.nom_value : audio_feedback_state.value;
+	uint32_t host_acc = 0;
+	int32_t fifo = target;
+	uint64_t refilled = 0;          // frames refilled into the ring
+	double last_bad_s = 0;
+	uint32_t fb_hist[1000] = { 0 }; // the 1s window
+	uint64_t fb_sum = 0;
+
+	uint16_t stall_ms = 0;          // deferred: the main loop is blocked for this long
+	uint16_t queued = 0;            // deferred: SOF events waiting for tud_task()
+	uint16_t sof_late = 0;          // ISR: SOFs merged into the next interrupt
+
+	for (uint32_t ms = 0; ms < SIM_MS; ++ms) {
+		const uint64_t played_total = (uint64_t)(ms * true_rate / 1000.0);
+
+		// feedback sampling at the SOF
+		if (sampling == SAMPLE_SOF_ISR) {
+			if (sof_late > 0) {
+				--sof_late;
+			} else {
+				static uint32_t last_frame;
+				const uint16_t sofs = (ms == 0) ? 1 : (uint16_t)(ms - last_frame);
+				last_frame = ms;
+				// the FIFO level without the played part of the current period, like tud_audio_feedback_interval_isr()
+				const int32_t buffered = fifo - (int32_t)(played_total % period);
+				fb = audio_feedback_update(played_frames(played_total, sofs), sofs, (uint16_t)(buffered > 0 ? buffered : 0), true);
+				if (rnd() < 0.001) {
+					sof_late = 1 + (uint16_t)(rnd() * 3);
+				}
+			}
+		} else if (sampling == SAMPLE_DEFERRED) {
+			queued = (queued < QUEUE_SZ) ? queued + 1 : QUEUE_SZ;
+			if (stall_ms > 0) {
+				--stall_ms;
+			} else {
+				// tud_task() handles every queued SOF at the same moment
+				for (; queued > 0; --queued) {
+					fb = audio_feedback_update(played_frames(played_total, 1), 1, (uint16_t)fifo, true);
+				}
+				if (rnd() < 0.002) {
+					stall_ms = 2 + (uint16_t)(rnd() * 20);
+				} else if (rnd() < 0.0002) {
+					stall_ms = 1000;    // I2C timeout
+				}
+			}
+		}
+
+		// the host packet, what the feedback asks for
+		host_acc += fb;
+		fifo += (int32_t)(host_acc >> 16);
+		host_acc &= 0xFFFF;
+		fifo = (fifo > fifo_size) ? fifo_size : fifo;
+		if (sampling == FIFO_COUNT) {
+			fb = fifo_count_update(&fc, (uint16_t)(fifo * FRAME_BYTES));
+		}
+
+		// the refill of every period the I2S finished until the next SOF
+		const uint64_t played_next = (uint64_t)((ms + 1) * true_rate / 1000.0);
+		while (refilled + period <= played_next + ring_frames) {
+			if (fifo < (int32_t)period) {
+				++r.underruns;
+				fifo = 0;
+			} else {
+				fifo -= (int32_t)period;
+			}
+			refilled += period;
+		}
+
+		const double t_s = ms / 1000.0;
+		fb_sum = fb_sum + fb - fb_hist[ms % 1000];
+		fb_hist[ms % 1000] = fb;
+		const double err_ppm = (fb_sum / 1000.0 / 65536.0 * 1000.0 / true_rate - 1.0) * 1e6;
+		// the 1st full window ends at 1s
+		if ((ms < 999) || (fabs(err_ppm) > RATE_TOL_PPM)) {
+			last_bad_s = t_s + 0.001;
+		}
+		if (t_s >= SETTLE_S) {
+			r.max_err_ppm = fmax(r.max_err_ppm, fabs(err_ppm));
+		}
+		if (t_s >= SETTLE_S) {
+			r.fifo_min = (fifo - target < r.fifo_min) ? fifo - target : r.fifo_min;
+			r.fifo_max = (fifo - target > r.fifo_max) ? fifo - target : r.fifo_max;
+		}
+	}
+
+	r.settle_s = last_bad_s;
+	return r;
+}
+
+int main(void) {
+	bool ok = true;
+	srand(1);
+
+	printf("%-6s %6s  %-10s %8s %10s %14s %9s\n", "rate", "ppm", "sampling", "settle", "max err", "FIFO ripple", "underrun");
+	for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+		const Case *c = &cases[i];
+		const int32_t packet = c->rate / 1000;
+
+		const Result r = run(c, SAMPLE_SOF_ISR);
+		const bool pass = (r.settle_s < SETTLE_S) && (r.max_err_ppm < RATE_TOL_PPM) && (r.underruns == 0)
+				&& (r.fifo_min > -2 * packet) && (r.fifo_max < 2 * packet);
+		ok &= pass;
+		printf("%-6u %+6.0f  %-10s %7.3fs %8.1fppm %6d..%-+6d %9u  %s\n", c->rate, c->ppm, "SOF ISR",
+				r.settle_s, r.max_err_ppm, r.fifo_min, r.fifo_max, r.underruns, pass ? "PASS" : "FAIL");
+
+		const Result d = run(c, SAMPLE_DEFERRED);
+		printf("%-6u %+6.0f  %-10s %7.3fs %8.1fppm %6d..%-+6d %9u  (old, reference)\n", c->rate, c->ppm, "deferred",
+				d.settle_s, d.max_err_ppm, d.fifo_min, d.fifo_max, d.underruns);
+
+		const Result f = run(c, FIFO_COUNT);
+		printf("%-6u %+6.0f  %-10s %7.3fs %8.1fppm %6d..%-+6d %9u  (tinyUSB, reference)\n", c->rate, c->ppm, "FIFO count",
+				f.settle_s, f.max_err_ppm, f.fifo_min, f.fifo_max, f.underruns);
+	}
+
+	printf("%s\n", ok ? "all passed" : "FAILED");
+	return ok ? 0 : 1;
+}
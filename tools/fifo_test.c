@@ -0,0 +1,87 @@
+// Host test of the USB FIFO to I2S unpack (project/Core/Src/audio_fifo.c) with the real tinyUSB FIFO
+//
+// A byte stream is written into a tu_fifo in 1ms packets and read out in refill periods, so the
+// read starts at every offset of the ring and the samples get split by the wrap around.
+// The result has to be bit identical to the byte wise reference repacking of the same stream,
+// for all 3 subslot sizes and for FIFO depths which are not a multiple of the frame.
+//
+// build & run:
+//   gcc -O2 -I../project/Core/Inc -I../project/tinyusb-src -o fifo_test fifo_test.c ../project/Core/Src/audio_fifo.c ../project/Core/Src/audio_salvage.c ../project/Core/Src/audio_unpack.c ../project/tinyusb-src/common/tusb_fifo.c && ./fifo_test
+
+#include "audio_fifo.h"
+#include <stdio.h>
+#include <string.h>
+
+#define STREAM_LEN      200000  // bytes
+#define MAX_DEPTH       4000
+#define PERIOD_SAMPLES  96      // 1ms stereo at 48kHz, like the refill
+
+static uint8_t stream[STREAM_LEN];
+static uint32_t out[STREAM_LEN / 2];
+static uint32_t ref[STREAM_LEN / 2];
+
+// byte wise references, through the Q31 value
+static void ref_unpack(uint32_t *dst, const uint8_t *src, uint32_t n, uint8_t bytes) {
+	for (uint32_t i = 0; i < n; ++i) {
+		const uint8_t *s = &src[i * bytes];
+		int32_t q;
+		switch (bytes) {
+		case 2: q = (int32_t)(((uint32_t)s[1] << 24) | ((uint32_t)s[0] << 16)); break;
+		case 3: q = (int32_t)(((uint32_t)s[2] << 24) | ((uint32_t)s[1] << 16) | ((uint32_t)s[0] << 8)); break;
+		default: q = (int32_t)(((uint32_t)s[3] << 24) | ((uint32_t)s[2] << 16) | ((uint32_t)s[1] << 8) | s[0]); break;
+		}
+		dst[i] = q31_to_i2s_frame(q);
+	}
+}
+
+// returns the number of mismatching samples
+static uint32_t run(uint16_t depth, uint8_t bytes) {
+	static uint8_t buf[MAX_DEPTH];
+	tu_fifo_t ff;
+	tu_fifo_config(&ff, buf, depth, false);
+
+	const AudioUnpackFunc unpack = unpack_get_kernel(bytes);
+	const uint16_t frame = 2 * bytes;
+	uint32_t wr = 0, rd_samples = 0, pkt = 0;
+
+	while (wr + 100 * frame < STREAM_LEN) {
+		// 44.1kHz like packet sizes (44 and 45 frames), written while there is space
+		const uint16_t len = (uint16_t)(((pkt++ % 10) == 9 ? 45 : 44) * frame);
+		if (tu_fifo_remaining(&ff) >= len) {
+			tu_fifo_write_n(&ff, &stream[wr], len);
+			wr += len;
+		}
+		rd_samples += audio_fifo_read_to_i2s(&ff, (uint8_t*)&out[rd_samples], PERIOD_SAMPLES, bytes, unpack);
+	}
+	while (tu_fifo_count(&ff) >= frame) {
+		rd_samples += audio_fifo_read_to_i2s(&ff, (uint8_t*)&out[rd_samples], PERIOD_SAMPLES, bytes, unpack);
+	}
+
+	ref_unpack(ref, stream, rd_samples, bytes);
+	uint32_t bad = (rd_samples * bytes != wr) ? 1 : 0;
+	for (uint32_t i = 0; i < rd_samples; ++i) {
+		bad += (out[i] != ref[i]);
+	}
+	return bad;
+}
+
+int main(void) {
+	for (uint32_t i = 0; i < STREAM_LEN; ++i) {
+		stream[i] = (uint8_t)(i * 131 + (i >> 8) * 7 + 1);
+	}
+
+	const uint8_t formats[] = { 2, 3, 4 };
+	uint32_t failed = 0;
+	for (unsigned f = 0; f < sizeof(formats); ++f) {
+		uint32_t bad_runs = 0;
+		// the firmware FIFO is 12 max packets, around it every remainder of the frame
+		for (uint16_t depth = 3520; depth <= 3528; ++depth) {
+			bad_runs += (run(depth, formats[f]) != 0);
+		}
+		printf("%u byte samples, FIFO depth 3520..3528: %s\n", formats[f], bad_runs == 0 ? "PASS" : "FAIL");
+		failed += bad_runs;
+	}
+
+	printf("%s\n", failed == 0 ? "all passed" : "FAILED");
+	return failed != 0;
+}
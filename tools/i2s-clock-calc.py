@@ -1,4 +1,6 @@
 import math
+import os
+import sys
 
 # ----------------- USER SETTINGS -----------------
 
@@ -25,6 +27,16 @@ PLLI2SR_RANGE = range(2, 8)     # 2..7
 
 TOP_RESULTS = 15  # how many best configs to print
 
+# Sample rate table (run with --rate-table to regenerate the header)
+# the best configuration for each supported rate, switched at runtime when the host selects another one
+# (the USB descriptor advertises only the rates which fit into the endpoint, see usb_descriptors.c)
+RATE_LIST = (44_100, 48_000, 88_200, 96_000)
+RATE_I2S_MAX = 192_000_000      # Hz, PLLI2S R output max of the F411
+RATE_PLLI2SN_RANGE = range(50, 433) # 50..432 on the F411
+RATE_I2SDIV_RANGE = range(2, 256)   # 2..255
+RATE_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                           "..", "project", "Core", "Inc", "i2s_rate_table.h")
+
 # ----------------- CALCULATION -----------------
 
 def calc_pll_in(hse, pllm):
@@ -62,7 +74,7 @@ def calc_i2s_internal_clk(i2sclk):
         tmp = (i2sclk / packetlength)  / TARGET_I2S_FREQ
 
     
-    tmp_int = math.round(tmp);
+    tmp_int = round(tmp);
     err = abs(100 * (tmp - tmp_int) / tmp_int);
     return err
 
@@ -110,3 +122,69 @@ else:
             f"I2S={r['I2S_Freq']/1e6:8.4f} MHz  "
             f"=> error={r['Error']:.8f} %"
         )
+
+
+# ----------------- SAMPLE RATE TABLE -----------------
+
+# sample rate produced by a complete configuration (same formula as the HAL, see above)
+def calc_fs(f_i2s, i2sdiv, odd):
+    if I2S_MCLKOUTPUT_ENABLE:
+        return f_i2s / 256 / (2 * i2sdiv + odd)
+    packetlength = 32 if I2S_DATAFORMAT_16B else 64
+    return f_i2s / packetlength / (2 * i2sdiv + odd)
+
+
+# the closest configuration for the rate, on a tie the first found (lowest PLLM / PLLI2SN)
+def find_rate_config(rate):
+    best = None
+    for pllm in PLLM_RANGE:
+        f_pll_in = calc_pll_in(HSE, pllm)
+        if not (PLL_IN_MIN <= f_pll_in <= PLL_IN_MAX):
+            continue
+
+        for plln in RATE_PLLI2SN_RANGE:
+            f_vco = calc_vco(f_pll_in, plln)
+            if not (VCO_MIN <= f_vco <= VCO_MAX):
+                continue
+
+            for pllr in PLLI2SR_RANGE:
+                f_i2s = calc_i2s(f_vco, pllr)
+                if not (I2S_MIN <= f_i2s <= RATE_I2S_MAX):
+                    continue
+
+                for i2sdiv in RATE_I2SDIV_RANGE:
+                    for odd in (0, 1):
+                        fs = calc_fs(f_i2s, i2sdiv, odd)
+                        ppm = (fs / rate - 1) * 1e6
+                        if best is None or abs(ppm) < abs(best[6]) - 1e-9:
+                            best = (pllm, plln, pllr, i2sdiv, odd, fs, ppm)
+    return best
+
+
+def write_rate_header(path):
+    with open(path, "w", newline="\n") as f:
+        f.write("// Generated by tools/i2s-clock-calc.py --rate-table, do not edit\n")
+        f.write(f"// HSE={HSE}Hz, the closest PLLI2S/I2SPR configuration for each sample rate\n\n")
+        f.write("#pragma once\n\n")
+        f.write("#include <stdint.h>\n\n")
+        f.write("typedef struct {\n")
+        f.write("\tuint32_t sample_rate;\n")
+        f.write("\tuint8_t plli2s_m;\n")
+        f.write("\tuint16_t plli2s_n;\n")
+        f.write("\tuint8_t plli2s_r;\n")
+        f.write("\tuint8_t i2s_div;\n")
+        f.write("\tuint8_t i2s_odd;\n")
+        f.write("\tint16_t ppm_x10;    // offset from the sample rate in 0.1ppm\n")
+        f.write("} I2sRateConfig;\n\n")
+        f.write(f"#define I2S_RATE_TABLE_LEN       {len(RATE_LIST)}\n\n")
+        f.write("static const I2sRateConfig i2s_rate_table[I2S_RATE_TABLE_LEN] = {\n")
+        for rate in RATE_LIST:
+            (pllm, plln, pllr, i2sdiv, odd, fs, ppm) = find_rate_config(rate)
+            f.write(f"\t{{ {rate:5d}, {pllm:2d}, {plln:3d}, {pllr}, {i2sdiv:3d}, {odd}, {round(ppm * 10):6d} }}, // {fs:.3f}Hz\n")
+            print(f"{rate}Hz: PLLM={pllm} PLLI2SN={plln} PLLI2SR={pllr} I2SDIV={i2sdiv} ODD={odd} -> {fs:.3f}Hz ({ppm:+.1f}ppm)")
+        f.write("};\n")
+
+
+if "--rate-table" in sys.argv:
+    write_rate_header(RATE_HEADER)
+    print(f"\n{len(RATE_LIST)} rates written to {os.path.normpath(RATE_HEADER)}")
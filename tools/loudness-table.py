@@ -0,0 +1,106 @@
+# Generates project/Core/Inc/loudness_table.h, the loudness compensation filters for every volume step
+#
+# The difference of the ISO 226:2003 equal-loudness contours at the reference level and at the
+# reduced (by the volume) level is approximated by a low and a high shelf. The pair is scaled
+# down by its max boost (makeup), so the filters never clip, the firmware stage gives the makeup back
+# after them, in the headroom the digital volume leaves for it.
+#
+# usage: python loudness-table.py
+
+import math
+import os
+
+from biquad_design import LOW_SHELF, HIGH_SHELF, rbj, scale, q31_initializer
+
+# ----------------- USER SETTINGS -----------------
+
+FS = 48_000                 # Hz, AUDIO_SAMPLING_RATE
+VOLUME_MIN_DB = -80         # SYSTEM_MIN_VOLUME_DB in audio_controls.c
+VOLUME_STEP_DB = 0.5        # table resolution
+REFERENCE_PHON = 83         # loudness at 0dB volume, the contours are relative to this
+MIN_PHON = 20               # the contours are defined from 20 phon
+
+BASS_FREQ = 100             # Hz, low shelf corner
+BASS_REF_FREQ = 63          # Hz, where the contour difference is taken for the low shelf
+BASS_MAX_DB = 15
+TREB_FREQ = 10_000          # Hz, high shelf corner
+TREB_REF_FREQ = 12_500      # Hz
+TREB_MAX_DB = 6
+SHELF_Q = 0.707
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                      "..", "project", "Core", "Inc", "loudness_table.h")
+
+# ----------------- ISO 226:2003 -----------------
+
+ISO_F = [20, 25, 31.5, 40, 50, 63, 80, 100, 125, 160, 200, 250, 315, 400, 500, 630, 800,
+         1000, 1250, 1600, 2000, 2500, 3150, 4000, 5000, 6300, 8000, 10000, 12500]
+ISO_AF = [0.532, 0.506, 0.480, 0.455, 0.432, 0.409, 0.387, 0.367, 0.349, 0.330, 0.315, 0.301, 0.288, 0.276,
+          0.267, 0.259, 0.253, 0.250, 0.246, 0.244, 0.243, 0.243, 0.243, 0.242, 0.242, 0.245, 0.254, 0.271, 0.301]
+ISO_LU = [-31.6, -27.2, -23.0, -19.1, -15.9, -13.0, -10.3, -8.1, -6.2, -4.5, -3.1, -2.0, -1.1, -0.4,
+          0.0, 0.3, 0.5, 0.0, -2.7, -4.1, -1.0, 1.7, 2.5, 1.2, -2.1, -7.1, -11.2, -10.7, -3.1]
+ISO_TF = [78.5, 68.7, 59.5, 51.1, 44.0, 37.5, 31.5, 26.5, 22.1, 17.9, 14.4, 11.4, 8.6, 6.2,
+          4.4, 3.0, 2.2, 2.4, 3.5, 1.7, -1.3, -4.2, -6.0, -5.4, -1.5, 6.0, 12.6, 13.9, 12.3]
+
+
+def spl(freq, phon):
+    """SPL of the 'phon' contour at 'freq' (one of ISO_F)"""
+    i = ISO_F.index(freq)
+    af, lu, tf = ISO_AF[i], ISO_LU[i], ISO_TF[i]
+    a = 4.47e-3 * (10 ** (0.025 * phon) - 1.15) + (0.4 * 10 ** ((tf + lu) / 10 - 9)) ** af
+    return 10 / af * math.log10(a) - lu + 94
+
+
+def compensation(freq, volume_db):
+    """boost needed at 'freq' (relative to 1kHz) when the level is lowered by 'volume_db'"""
+    phon = max(REFERENCE_PHON + volume_db, MIN_PHON)
+    return (spl(freq, phon) - phon) - (spl(freq, REFERENCE_PHON) - REFERENCE_PHON)
+
+
+# ----------------- TABLE -----------------
+
+def calc_entry(volume_db):
+    bass = min(max(compensation(BASS_REF_FREQ, volume_db), 0), BASS_MAX_DB)
+    treb = min(max(compensation(TREB_REF_FREQ, volume_db), 0), TREB_MAX_DB)
+    # can't be more than the attenuation itself
+    makeup = min(max(bass, treb), -volume_db)
+
+    gain = 10 ** (-makeup / 20)
+    low = scale(rbj(LOW_SHELF, BASS_FREQ, bass, SHELF_Q, FS), gain)
+    high = rbj(HIGH_SHELF, TREB_FREQ, treb, SHELF_Q, FS)
+    return bass, treb, makeup, low, high
+
+
+def write_header(path):
+    steps = int(round(-VOLUME_MIN_DB / VOLUME_STEP_DB)) + 1
+    with open(path, "w", newline="\n") as f:
+        f.write("// Generated by tools/loudness-table.py, do not edit\n")
+        f.write(f"// fs={FS}Hz, reference {REFERENCE_PHON} phon at 0dB, low shelf {BASS_FREQ}Hz, high shelf {TREB_FREQ}Hz\n\n")
+        f.write("#pragma once\n\n")
+        f.write("#include <stdint.h>\n")
+        f.write("#include \"audio_biquad.h\"\n\n")
+        f.write("typedef struct {\n")
+        f.write("\tAudioBiquadQ31Coef low;   // low shelf, already lowered by the makeup\n")
+        f.write("\tAudioBiquadQ31Coef high;  // high shelf\n")
+        f.write("\tint16_t makeup_db_x10;    // max boost of the pair, the stage gain after the filters\n")
+        f.write("} LoudnessEntry;\n\n")
+        f.write(f"#define LOUDNESS_TABLE_FS        {FS}\n")
+        f.write(f"#define LOUDNESS_TABLE_LEN       {steps}\n")
+        f.write(f"#define LOUDNESS_STEP_DB_X10     {int(round(VOLUME_STEP_DB * 10))}\n\n")
+        f.write("// index: -volume / LOUDNESS_STEP_DB_X10\n")
+        f.write("static const LoudnessEntry loudness_table[LOUDNESS_TABLE_LEN] = {\n")
+        for i in range(steps):
+            volume = -i * VOLUME_STEP_DB
+            bass, treb, makeup, low, high = calc_entry(volume)
+            f.write(f"\t{{ {q31_initializer(low)},\n\t  {q31_initializer(high)}, {int(round(makeup * 10)):4d} }}, "
+                    f"// {volume:5.1f}dB: bass +{bass:4.1f}dB, treble +{treb:3.1f}dB\n")
+        f.write("};\n")
+    return steps
+
+
+if __name__ == "__main__":
+    for v in (0, -10, -20, -30, -40, -60, -80):
+        bass, treb, makeup, _, _ = calc_entry(v)
+        print(f"{v:4d}dB: bass +{bass:4.1f}dB, treble +{treb:3.1f}dB, makeup {makeup:4.1f}dB")
+    n = write_header(HEADER)
+    print(f"\n{n} entries written to {os.path.normpath(HEADER)}")
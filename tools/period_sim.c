@@ -0,0 +1,162 @@
+// Host simulation of the I2S DMA period scheduler (service_periods() in project/Core/Src/CS43L22_driver.c)
+//
+// This is a model: service_periods() is tied to the HAL DMA and the driver state, so its logic
+// (refill every period the DMA position shows as played, starting from fill_period) is written again
+// here and not compiled from the firmware. A change of the scheduler has to be made here as well.
+//
+// The DMA plays a ring of PERIOD_CNT periods and raises the half and the complete interrupts,
+// the callback runs after some ISR latency (jitter), reads the DMA position and refills every
+// period which was played completely since the last refill. A period which starts playing again
+// before it was refilled is an underrun. Like on the NVIC, an interrupt which is raised again while
+// it is still pending is lost (only the next callback sees the DMA position).
+//
+// For each ring the tolerated constant callback delay is measured and checked against the analytic one
+// (each period has to be refilled by the first callback after its end, before it is played again),
+// then the underruns are reported for a few jitter distributions.
+//
+// build & run:
+//   gcc -O2 -o period_sim period_sim.c -lm && ./period_sim
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SIM_US          (10 * 1000 * 1000)  // 10s of playback per case
+
+typedef struct {
+	int cnt;        // AUDIO_PERIOD_CNT
+	int period_us;  // AUDIO_PERIOD_US
+} Ring;
+
+typedef enum { JIT_CONST, JIT_UNIFORM, JIT_STALLS } JitterKind;
+
+typedef struct {
+	const char *name;
+	JitterKind kind;
+	double a, b;    // const: delay / uniform: max / stalls: probability, length
+} Jitter;
+
+static double rnd(void) {
+	return rand() / (RAND_MAX + 1.0);
+}
+
+static double delay_us(const Jitter *j) {
+	switch (j->kind) {
+	case JIT_CONST:   return j->a;
+	case JIT_UNIFORM: return rnd() * j->a;
+	default:          return 5.0 + (rnd() < j->a ? j->b : 0.0); // the main loop sometimes masks the IRQ (I2C, printf)
+	}
+}
+
+// returns the underruns in SIM_US
+static long simulate(const Ring *r, const Jitter *j) {
+	const long ring_us = (long)r->cnt * r->period_us;
+	const long half_us = ring_us / 2;
+
+	// refill bookkeeping, the 1st round of every period is the pre-filled silence
+	int filled[16], played[16];
+	for (int p = 0; p < r->cnt; ++p) {
+		filled[p] = 1;
+		played[p] = 0;
+	}
+	int fill_period = 0;
+	long underruns = 0;
+	long next_start = 0;    // the next period start, in periods since 0
+
+	double irq = half_us;   // the next half/complete interrupt
+	while (irq < SIM_US) {
+		const double cb = irq + delay_us(j);
+
+		// every period which starts before the callback has to be refilled by now
+		while ((double)next_start * r->period_us < cb) {
+			const int p = (int)(next_start % r->cnt);
+			if (filled[p] <= played[p]) {
+				++underruns;
+			}
+			++played[p];
+			++next_start;
+		}
+
+		// the callback, the same as service_periods(): refill up to the period the DMA is in
+		const long pos_us = (long)cb % ring_us;
+		const int play_period = (int)(pos_us / r->period_us);
+		while (fill_period != play_period) {
+			filled[fill_period] = played[fill_period] + 1;
+			fill_period = (fill_period + 1) % r->cnt;
+		}
+
+		// the interrupts raised while this one was pending are merged into it
+		irq = (floor(cb / half_us) + 1) * half_us;
+	}
+	return underruns;
+}
+
+// the longest constant callback delay without underruns, analytic (for delays below half a ring,
+// above it the interrupts are merged): the callback of the k-th interrupt runs at k * half + delay,
+// a period is refilled by the first one after its end and it has to be before its next start
+static long tolerance_us(const Ring *r) {
+	const long ring_us = (long)r->cnt * r->period_us;
+	const long half_us = ring_us / 2;
+	long tol = -1;
+	for (long d = 0; d < half_us; ++d) {
+		for (int p = 0; p < r->cnt; ++p) {
+			const long end = (long)(p + 1) * r->period_us;
+			long k = (end - d + half_us - 1) / half_us;
+			k = (k < 1) ? 1 : k;
+			if (k * half_us + d > end + ring_us - r->period_us) {
+				return tol;
+			}
+		}
+		tol = d;
+	}
+	return tol;
+}
+
+int main(void) {
+	const Ring rings[] = { { 2, 1000 }, { 4, 500 }, { 3, 1000 }, { 4, 1000 }, { 3, 2000 } };
+	const Jitter jitters[] = {
+		{ "none",              JIT_CONST,   0,     0 },
+		{ "uniform 0-500us",   JIT_UNIFORM, 500,   0 },
+		{ "uniform 0-1500us",  JIT_UNIFORM, 1500,  0 },
+		{ "1% stalls of 2ms",  JIT_STALLS,  0.01,  2000 },
+		{ "1% stalls of 4ms",  JIT_STALLS,  0.01,  4000 },
+	};
+	const int n_rings = sizeof(rings) / sizeof(rings[0]);
+	const int n_jit = sizeof(jitters) / sizeof(jitters[0]);
+	int failed = 0;
+
+	printf("tolerated constant callback delay (max half a ring):\n");
+	for (int i = 0; i < n_rings; ++i) {
+		long measured = -1;
+		for (long d = 0; d < rings[i].cnt * rings[i].period_us; d += 10) {
+			const Jitter c = { "", JIT_CONST, (double)d, 0 };
+			if (simulate(&rings[i], &c) != 0) {
+				break;
+			}
+			measured = d;
+		}
+		const long expected = tolerance_us(&rings[i]);
+		const int ok = (measured <= expected) && (measured >= expected - 10);
+		failed += !ok;
+		printf("  %d x %4dus: %5ldus (analytic %5ldus) %s\n", rings[i].cnt, rings[i].period_us,
+				measured, expected, ok ? "PASS" : "FAIL");
+	}
+
+	printf("\nunderruns in %ds:\n%-18s", SIM_US / 1000000, "");
+	for (int i = 0; i < n_rings; ++i) {
+		printf("  %dx%-5d", rings[i].cnt, rings[i].period_us);
+	}
+	printf("\n");
+	for (int k = 0; k < n_jit; ++k) {
+		printf("%-18s", jitters[k].name);
+		for (int i = 0; i < n_rings; ++i) {
+			srand(1);
+			printf("  %7ld", simulate(&rings[i], &jitters[k]));
+		}
+		printf("\n");
+	}
+
+	printf("\n%s\n", failed == 0 ? "all passed" : "FAILED");
+	return failed != 0;
+}
@@ -0,0 +1,279 @@
+// Host test of the adaptive pre-roll (project/Core/Src/audio_preroll.c) replaying packet arrival traces
+//
+// The host sends a 48kHz 24bit stream in 1ms packets, in sessions of a few seconds with pauses between them
+// (every session is a new start from the pre-roll). The packets arrive with the jitter of the trace,
+// the I2S refill reads one packet worth every 1ms at its own phase and audio_task() runs every 1ms,
+// like in project/Core/Src/usb_handler.c: it starts the playback at the pre-roll and stops it
+// when the FIFO runs dry. A short refill or a stop while the host still streams is a dropout.
+// The fade in / out is not modelled, the FIFO is read only while streaming.
+//
+// A well behaved host has to end at the smallest pre-roll without a dropout, a jittery one
+// (USB-C dock like stalls) has to get a larger pre-roll and play the second half of the trace without a dropout.
+// A host whose problem is not visible as jitter (late packets within the 1ms, or a FIFO which drains)
+// is caught by the dropouts and by the FIFO minimum (near underruns). The pre-roll which failed is tried again
+// after PREROLL_WINDOW_MS, so in the second half it may have at most one dropout per window.
+//
+// Traces of a real host can be given as files, one packet interval in us per line ('#' starts a comment),
+// e.g. the differences of the ISO OUT URB timestamps of a usbmon / Wireshark capture. A file is replayed
+// from the start again when it is shorter than the simulation, it passes with the same limit
+// as the retry case above. traces/ has the ones checked so far.
+//
+// build & run:
+//   gcc -O2 -I../project/Core/Inc -o preroll_test preroll_test.c ../project/Core/Src/audio_preroll.c && ./preroll_test traces/*.txt
+
+#include "audio_preroll.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_MS          60000
+#define SESSION_MS      4000    // streaming
+#define PAUSE_MS        500     // the host does not stream
+#define PACKET_LEN      (48 * 6)
+#define FIFO_SIZE       (12 * PACKET_LEN)
+#define REFILL_PHASE_US 300     // where the DMA period ends in each ms
+#define TASK_PHASE_US   700     // where audio_task() runs in each ms at the latest, the main loop is late by up to that
+
+typedef enum { TRACE_CLEAN, TRACE_PAIRS, TRACE_STALLS, TRACE_SLOW } TraceKind;
+
+typedef enum {
+	EXPECT_MIN,             // the smallest pre-roll, no dropout
+	EXPECT_ADAPT,           // a larger pre-roll, no dropout in the second half
+	EXPECT_RETRY,           // max one dropout per window in the second half
+} Expect;
+
+typedef struct {
+	const char *name;
+	TraceKind kind;
+	double stall_prob;      // per packet
+	int stall_ms;           // stalls: the held packets come all at the end of the stall
+	                        // slow: every stall_ms-th packet is one frame short
+	Expect expect;
+} Trace;
+
+static const Trace traces[] = {
+	{ "clean host (50us jitter)",          TRACE_CLEAN,  0,      0,  EXPECT_MIN   },
+	{ "skipped frames, 1ms every ~0.5s",   TRACE_STALLS, 0.002,  1,  EXPECT_ADAPT },
+	{ "dock, 2ms stalls every ~0.5s",      TRACE_STALLS, 0.002,  2,  EXPECT_ADAPT },
+	{ "dock, 3ms stalls every ~2s",        TRACE_STALLS, 0.0005, 3,  EXPECT_ADAPT },
+	{ "bunched pairs (800us jitter)",      TRACE_PAIRS,  0,      0,  EXPECT_RETRY },
+	// no jitter at all, but the FIFO drains (a feedback which did not settle yet)
+	{ "slow host (-520ppm)",               TRACE_SLOW,   0,      40, EXPECT_RETRY },
+};
+
+static double rnd(void) {
+	return rand() / (RAND_MAX + 1.0);
+}
+
+// arrival time of every packet in us, the packet k is sent for the ms k
+static uint32_t arrival_us[SIM_MS];
+static uint16_t packet_len[SIM_MS];
+
+static void make_trace(const Trace *t) {
+	uint32_t held_until = 0;
+	for (uint32_t k = 0; k < SIM_MS; ++k) {
+		uint32_t at = k * 1000 + (uint32_t)(rnd() * 50);
+		if (t->kind == TRACE_PAIRS) {
+			// every 2nd packet late, right before the next one
+			at += (k & 1) ? 0 : 800;
+		} else if (t->kind == TRACE_STALLS) {
+			if ((held_until <= at) && (rnd() < t->stall_prob)) {
+				held_until = at + t->stall_ms * 1000;
+			}
+			if (at < held_until) {
+				at = held_until;
+			}
+		}
+		arrival_us[k] = at;
+		packet_len[k] = ((t->kind == TRACE_SLOW) && (k % t->stall_ms == 0)) ? PACKET_LEN - 6 : PACKET_LEN;
+	}
+}
+
+// returns false when the file has no interval
+static bool load_trace(const char *path) {
+	FILE *f = fopen(path, "r");
+	if (f == NULL) {
+		return false;
+	}
+
+	static uint32_t interval_us[SIM_MS];
+	uint32_t n = 0;
+	char line[64];
+	while ((n < SIM_MS) && (fgets(line, sizeof(line), f) != NULL)) {
+		char *end;
+		const unsigned long v = strtoul(line, &end, 10);
+		if ((end != line) && (line[0] != '#')) {
+			interval_us[n++] = (uint32_t)v;
+		}
+	}
+	fclose(f);
+
+	uint32_t at = 0;
+	for (uint32_t k = 0; (n != 0) && (k < SIM_MS); ++k) {
+		at += interval_us[k % n];
+		arrival_us[k] = at;
+		packet_len[k] = PACKET_LEN;
+	}
+	return n != 0;
+}
+
+static bool host_streaming(uint32_t ms) {
+	return (ms % (SESSION_MS + PAUSE_MS)) < SESSION_MS;
+}
+
+typedef struct {
+	uint32_t dropouts;
+	uint32_t late_dropouts;     // in the second half
+	uint32_t starts;
+	uint8_t preroll;
+	uint32_t near_underruns;
+} Result;
+
+static Result run(void) {
+	audio_preroll_reset();
+
+	Result r = { 0 };
+	uint32_t fill = 0;
+	bool playing = false;
+	bool short_read = false;
+	bool starved = false;
+	uint32_t next_packet = 0;
+	uint32_t last_arrival = 0;
+	uint32_t task_phase_us = 0;
+
+	for (uint32_t us = 0; us < SIM_MS * 1000; ++us) {
+		const uint32_t ms = us / 1000;
+
+		// packets of the sessions only, the pause is silence on the bus
+		while ((next_packet < SIM_MS) && (arrival_us[next_packet] <= us)) {
+			if (host_streaming(next_packet)) {
+				fill = (fill + packet_len[next_packet] <= FIFO_SIZE) ? fill + packet_len[next_packet] : fill;
+				audio_preroll_packet(us - last_arrival, fill, playing);
+				last_arrival = us;
+			}
+			++next_packet;
+		}
+
+		if ((us % 1000 == REFILL_PHASE_US) && playing) {
+			// the firmware reads whole frames only and conceals the rest
+			if (fill < PACKET_LEN) {
+				short_read = true;
+				fill = 0;
+			} else {
+				fill -= PACKET_LEN;
+			}
+		}
+
+		if (us % 1000 == task_phase_us) {
+			// update_preroll()
+			const bool underrun = (short_read && host_streaming(ms) && playing) || starved;
+			short_read = false;
+			starved = false;
+			if (underrun) {
+				++r.dropouts;
+				if (ms >= SIM_MS / 2) {
+					++r.late_dropouts;
+				}
+			}
+			audio_preroll_update(ms, underrun, PACKET_LEN);
+
+			// audio_task()
+			if (host_streaming(ms) && !playing && (fill >= preroll_stats.preroll * PACKET_LEN)) {
+				audio_preroll_started();
+				playing = true;
+				++r.starts;
+			}
+			if (playing && (fill < PACKET_LEN)) {
+				starved = host_streaming(ms);
+				playing = false;
+			}
+			// the rest of a session is thrown away by the next alternate setting
+			if (!host_streaming(ms) && !playing) {
+				fill = 0;
+			}
+			task_phase_us = (uint32_t)(rnd() * TASK_PHASE_US);
+		}
+	}
+
+	r.preroll = preroll_stats.preroll;
+	r.near_underruns = preroll_stats.near_underruns;
+	return r;
+}
+
+// A playback which went below the stop level without stopping (only the FIFO minimum shows it)
+// has to raise the pre-roll for the next start, and the pre-roll has to come back after the window.
+static bool check_near_underrun(void) {
+	audio_preroll_reset();
+	for (uint32_t ms = 1; ms <= 3; ++ms) {
+		audio_preroll_packet(1000, 3 * PACKET_LEN, false);
+		audio_preroll_update(ms, false, PACKET_LEN);
+	}
+	const uint8_t before = preroll_stats.preroll;
+
+	audio_preroll_started();
+	audio_preroll_packet(1000, 3 * PACKET_LEN, true);
+	audio_preroll_packet(1000, 2 * PACKET_LEN - 6, true);
+	audio_preroll_packet(1000, 3 * PACKET_LEN, true);
+	audio_preroll_update(4, false, PACKET_LEN);
+	const uint8_t raised = preroll_stats.preroll;
+
+	audio_preroll_update(4 + PREROLL_WINDOW_MS, false, PACKET_LEN);
+	const uint8_t later = preroll_stats.preroll;
+
+	const bool pass = (before == PREROLL_MIN) && (raised == PREROLL_MIN + 1) && (later == PREROLL_MIN)
+			&& (preroll_stats.near_underruns == 1) && (preroll_stats.underruns == 0);
+	printf("near underrun: pre-roll %u -> %u -> %u after the window  %s\n", before, raised, later,
+			pass ? "PASS" : "FAIL");
+	return pass;
+}
+
+int main(int argc, char *argv[]) {
+	bool ok = true;
+	srand(1);
+
+	ok &= check_near_underrun();
+
+	printf("%-32s %8s %8s %8s %8s %8s\n", "trace", "starts", "dropout", "2nd half", "near", "preroll");
+	for (size_t i = 0; i < sizeof(traces) / sizeof(traces[0]); ++i) {
+		const Trace *t = &traces[i];
+		make_trace(t);
+		const Result r = run();
+
+		bool pass;
+		switch (t->expect) {
+		case EXPECT_MIN:
+			pass = (r.preroll == PREROLL_MIN) && (r.dropouts == 0);
+			break;
+		case EXPECT_ADAPT:
+			pass = (r.preroll > PREROLL_MIN) && (r.late_dropouts == 0);
+			break;
+		default:
+			pass = (r.late_dropouts <= SIM_MS / 2 / PREROLL_WINDOW_MS);
+			break;
+		}
+		ok &= pass;
+
+		printf("%-32s %8u %8u %8u %8u %8u  %s\n", t->name, r.starts, r.dropouts, r.late_dropouts,
+				r.near_underruns, r.preroll, pass ? "PASS" : "FAIL");
+	}
+
+	for (int i = 1; i < argc; ++i) {
+		if (!load_trace(argv[i])) {
+			printf("%-32s cannot read  FAIL\n", argv[i]);
+			ok = false;
+			continue;
+		}
+		const Result r = run();
+
+		const bool pass = (r.late_dropouts <= SIM_MS / 2 / PREROLL_WINDOW_MS);
+		ok &= pass;
+
+		printf("%-32s %8u %8u %8u %8u %8u  %s\n", argv[i], r.starts, r.dropouts, r.late_dropouts,
+				r.near_underruns, r.preroll, pass ? "PASS" : "FAIL");
+	}
+
+	printf("%s\n", ok ? "all passed" : "FAILED");
+	return ok ? 0 : 1;
+}
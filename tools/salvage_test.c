@@ -0,0 +1,180 @@
+// Host test of the misaligned packet recovery (audio_fifo_realign_packet() in project/Core/Src/audio_fifo.c,
+// project/Core/Src/audio_salvage.c) with the real tinyUSB FIFO
+//
+// A stereo stream of two sines (different frequencies, so a L/R swap is a jump as well) is sent in 1ms packets.
+// Some packets get bytes lost or inserted at a random place, like from the USB-C dock in tud_audio_rx_done_isr().
+// Every packet is written to an overwritable tu_fifo of the firmware's size and realigned right away,
+// the I2S side reads 1ms periods after a 4 packet pre-roll.
+// Checks:
+//  - alignment: after every packet the FIFO holds whole frames
+//  - glitches: places where a sample of the output jumps by more than STEP_LIMIT times the steepest step
+//    of its sine (a lost frame doubles a step, a byte shifted frame is a jump of up to full scale).
+//    The split is found from the signal itself, so now and then a shifted frame looks smooth by chance
+//    or a half frame shift (it only swaps L/R) is taken for the right one - at most MAX_GLITCH_PCT
+//    of the broken packets may leave a glitch.
+//  - counts: every broken packet went through the salvage, breaks at the start and in the middle were seen.
+//    A break in the last frame is mostly a split before it, the last frame is then held (not a tail).
+// For comparison the same stream is also checked with the broken packets only cut to whole frames.
+//
+// build & run:
+//   gcc -O2 -I../project/Core/Inc -I../project/tinyusb-src -o salvage_test salvage_test.c ../project/Core/Src/audio_fifo.c ../project/Core/Src/audio_salvage.c ../project/Core/Src/audio_unpack.c ../project/tinyusb-src/common/tusb_fifo.c -lm && ./salvage_test
+
+#include "audio_fifo.h"
+#include "audio_salvage.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FS              48000.0
+#define PACKETS         20000
+#define PACKET_FRAMES   48
+#define BREAK_EVERY     20      // about every 20th packet is broken
+#define PREROLL         4       // packets
+#define STEP_LIMIT      3.0
+#define MAX_GLITCH_PCT  2
+#define GLITCH_FRAMES   2       // steps closer than this are one glitch
+#define FIFO_DEPTH      CFG_TUD_AUDIO_FUNC_1_EP_OUT_SW_BUF_SZ
+
+static const double freq[2] = { 997.0, 1499.0 };
+static const double ampl = 0.5;
+
+static uint8_t fifo_buf[FIFO_DEPTH];
+static uint32_t out[2 * PACKET_FRAMES * PACKETS * 2];
+
+static double rnd(void) {
+	return rand() / (RAND_MAX + 1.0);
+}
+
+static void put_s24(uint8_t *p, int32_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+}
+
+static void put_sample(uint8_t *p, double v, uint8_t bytes) {
+	const int32_t q = (int32_t)lrint(v * 2147483647.0);
+	switch (bytes) {
+	case 2: p[0] = (uint8_t)(q >> 16); p[1] = (uint8_t)(q >> 24); break;
+	case 3: put_s24(p, q >> 8); break;
+	default: memcpy(p, &q, 4); break;
+	}
+}
+
+typedef struct {
+	uint32_t broken;
+	uint32_t misaligned;    // packets after which the FIFO was not whole frames
+	uint32_t glitches;      // places with samples over the step limit
+	uint32_t samples;
+} Result;
+
+// 'salvage' - audio_fifo_realign_packet(), otherwise the broken packet is only cut to whole frames
+static Result run(uint8_t bytes, bool salvage, bool tail_only) {
+	tu_fifo_t ff;
+	tu_fifo_config(&ff, fifo_buf, FIFO_DEPTH, true);
+	memset(&audio_salvage_stats, 0, sizeof(audio_salvage_stats));
+	srand(7);
+
+	const AudioUnpackFunc unpack = unpack_get_kernel(bytes);
+	const uint16_t frame = 2 * bytes;
+	uint8_t packet[PACKET_FRAMES * 8 + 8];
+	Result r = { 0 };
+	uint32_t n_out = 0;
+	uint64_t t = 0;
+
+	for (uint32_t k = 0; k < PACKETS; ++k) {
+		uint16_t len = PACKET_FRAMES * frame;
+		for (uint16_t i = 0; i < PACKET_FRAMES; ++i, ++t) {
+			for (uint8_t ch = 0; ch < 2; ++ch) {
+				put_sample(&packet[i * frame + ch * bytes], ampl * sin(2 * M_PI * freq[ch] * t / FS), bytes);
+			}
+		}
+
+		if ((k > PREROLL) && (rnd() < 1.0 / BREAK_EVERY)) {
+			// 1..frame-1 bytes lost or inserted somewhere, or lost at the end
+			uint16_t cnt = 1 + (uint16_t)(rnd() * (frame - 1));
+			if (tail_only && (2 * cnt == frame)) {
+				// half a frame lost at the end leaves a valid looking stream with L/R swapped,
+				// only the next packet shows where it went wrong
+				++cnt;
+			}
+			const uint16_t pos = tail_only ? len - cnt : (uint16_t)(rnd() * (len - cnt));
+			if (tail_only || (rnd() < 0.7)) {
+				memmove(&packet[pos], &packet[pos + cnt], len - pos - cnt);
+				len -= cnt;
+			} else {
+				memmove(&packet[pos + cnt], &packet[pos], len - pos);
+				for (uint16_t i = 0; i < cnt; ++i) {
+					packet[pos + i] = (uint8_t)rand();
+				}
+				len += cnt;
+			}
+			++r.broken;
+		}
+
+		tu_fifo_write_n(&ff, packet, len);
+		if (salvage) {
+			audio_fifo_realign_packet(&ff, len, bytes);
+		} else if (len % frame) {
+			tu_fifo_advance_write_pointer(&ff, (uint16_t)(2 * ff.depth - len % frame));
+		}
+		r.misaligned += (tu_fifo_count(&ff) % frame) != 0;
+
+		if (k >= PREROLL) {
+			n_out += audio_fifo_read_to_i2s(&ff, (uint8_t*)&out[n_out], 2 * PACKET_FRAMES, bytes, unpack);
+		}
+	}
+
+	// the steepest step of each sine, 1 LSB of the format for the rounding
+	double limit[2];
+	for (uint8_t ch = 0; ch < 2; ++ch) {
+		limit[ch] = STEP_LIMIT * (ampl * 2 * M_PI * freq[ch] / FS + 1.0 / (1 << (8 * (bytes > 3 ? 3 : bytes) - 1)));
+	}
+	// a step in either channel within a few frames of the last one is the same glitch
+	uint32_t last = 0;
+	for (uint32_t i = 2; i < n_out; ++i) {
+		const double step = fabs((double)i2s_frame_to_q31(out[i]) - (double)i2s_frame_to_q31(out[i - 2])) / 2147483648.0;
+		if (step > limit[i & 1]) {
+			r.glitches += (last == 0) || (i - last > 2 * GLITCH_FRAMES);
+			last = i;
+		}
+	}
+	r.samples = n_out;
+	return r;
+}
+
+int main(void) {
+	bool ok = true;
+
+	// salvaged, breaks anywhere and at the end only
+	for (uint8_t tail_only = 0; tail_only < 2; ++tail_only) {
+		const Result s = run(3, true, tail_only);
+		const AudioSalvageStats st = audio_salvage_stats;
+		bool pass_s = (s.misaligned == 0) && (s.glitches * 100 <= s.broken * MAX_GLITCH_PCT) && (st.packets == s.broken);
+		if (!tail_only) {
+			pass_s &= (st.head > 0) && (st.split > 0);
+		}
+		ok &= pass_s;
+		printf("24bit, salvaged, %s: %u broken packets (head %u, split %u, tail %u, dropped %u), misaligned %u, glitches %u  %s\n",
+				tail_only ? "at the end" : "anywhere  ", s.broken, st.head, st.split, st.tail, st.dropped, s.misaligned, s.glitches,
+				pass_s ? "PASS" : "FAIL");
+	}
+
+	const Result c = run(3, false, false);
+	printf("24bit, cut to frames:          %u broken packets, misaligned %u, glitches %u  (reference)\n",
+			c.broken, c.misaligned, c.glitches);
+
+	// the other sizes only drop the incomplete frame at the end
+	const uint8_t others[] = { 2, 4 };
+	for (unsigned i = 0; i < sizeof(others); ++i) {
+		const Result o = run(others[i], true, true);
+		const bool pass_o = (o.misaligned == 0) && (o.glitches == 0);
+		ok &= pass_o;
+		printf("%ubit, cut at the end:          %u broken packets, misaligned %u, glitches %u  %s\n",
+				8 * others[i], o.broken, o.misaligned, o.glitches, pass_o ? "PASS" : "FAIL");
+	}
+
+	printf("%s\n", ok ? "all passed" : "FAILED");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+# Generates project/Core/Inc/tone_table.h, the software bass/treble shelves for every UI step
+#
+# Every gain step (TONE_MIN..TONE_MAX by TONE_STEP) of every frequency preset (bass_freqs/treb_freqs)
+# of audio_controls.c is precomputed, so a button press is only a pointer change, no trigonometry.
+#
+# usage: python tone-table.py
+
+import os
+
+from biquad_design import LOW_SHELF, HIGH_SHELF, rbj, q31_initializer
+
+# ----------------- USER SETTINGS -----------------
+
+FS = 48_000                       # Hz, AUDIO_SAMPLING_RATE
+
+# these have to match audio_controls.c (x10 dB)
+TONE_MIN = -105
+TONE_MAX = 120
+TONE_STEP = 15
+BASS_FREQS = [50, 100, 200, 250]            # bass_freqs
+TREB_FREQS = [5000, 7000, 10000, 15000]     # treb_freqs
+
+SHELF_Q = 0.707                   # the steepest slope without an overshoot
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                      "..", "project", "Core", "Inc", "tone_table.h")
+
+# ----------------- TABLE -----------------
+
+def write_table(f, name, kind, freqs, steps):
+    f.write(f"static const AudioBiquadQ31Coef {name}[TONE_TABLE_FREQ_CNT][TONE_TABLE_STEPS] = {{\n")
+    for freq in freqs:
+        f.write(f"\t{{ // {freq}Hz\n")
+        for i in range(steps):
+            gain = (TONE_MIN + i * TONE_STEP) / 10
+            f.write(f"\t\t{q31_initializer(rbj(kind, freq, gain, SHELF_Q, FS))}, // {gain:+5.1f}dB\n")
+        f.write("\t},\n")
+    f.write("};\n\n")
+
+
+def write_header(path):
+    steps = (TONE_MAX - TONE_MIN) // TONE_STEP + 1
+    with open(path, "w", newline="\n") as f:
+        f.write("// Generated by tools/tone-table.py, do not edit\n")
+        f.write(f"// fs={FS}Hz, shelves with Q={SHELF_Q}\n\n")
+        f.write("#pragma once\n\n")
+        f.write("#include \"audio_biquad.h\"\n\n")
+        f.write(f"#define TONE_TABLE_FS            {FS}\n")
+        f.write(f"#define TONE_TABLE_MIN_DB_X10    ({TONE_MIN})\n")
+        f.write(f"#define TONE_TABLE_STEP_DB_X10   {TONE_STEP}\n")
+        f.write(f"#define TONE_TABLE_STEPS         {steps}\n")
+        f.write(f"#define TONE_TABLE_FREQ_CNT      {len(BASS_FREQS)}\n\n")
+        f.write("// [frequency preset][(gain - TONE_TABLE_MIN_DB_X10) / TONE_TABLE_STEP_DB_X10]\n")
+        write_table(f, "tone_bass_table", LOW_SHELF, BASS_FREQS, steps)
+        write_table(f, "tone_treb_table", HIGH_SHELF, TREB_FREQS, steps)
+    return steps
+
+
+if __name__ == "__main__":
+    assert len(BASS_FREQS) == len(TREB_FREQS)
+    n = write_header(HEADER)
+    print(f"{2 * len(BASS_FREQS)} x {n} shelves written to {os.path.normpath(HEADER)}")